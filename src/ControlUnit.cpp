@@ -1,7 +1,76 @@
 #include <systemc.h>
+#include <vector>
 
 #include "rahmenprogramm.h"
+#include "log.h"
+#include "latency_stats.h"
+#include "cache.hpp"
 #include "memory_controller.hpp"
+#include "multi_master.hpp"
+#include "sim_profile.hpp"
+#include "trace_window.hpp"
+#include "sim_session.h"
+
+// Hält sc_start() an, sobald ready eine steigende Flanke hat. So muss die Testbench nicht
+// jeden Taktzyklus einzeln simulieren, um auf die Antwort des Memory-Controllers zu warten.
+SC_MODULE(READY_MONITOR), public ActivityCounter
+{
+    sc_in<bool> ready;
+
+    bool armed;
+    bool fired;
+
+    SC_HAS_PROCESS(READY_MONITOR);
+
+    READY_MONITOR(sc_module_name name) : sc_module(name), armed(false), fired(false)
+    {
+        SC_METHOD(onReady);
+        sensitive << ready.pos();
+        dont_initialize();
+    }
+
+    void onReady()
+    {
+        ActivityScope scope(*this);
+        if (armed)
+        {
+            armed = false;
+            fired = true;
+            sc_pause();
+        }
+    }
+};
+
+// Für die 32-Bit-Zähler in struct Result: lange Läufe bleiben bei UINT32_MAX stehen, statt
+// überzulaufen.
+static uint32_t saturate32(uint64_t value)
+{
+    return value < UINT32_MAX ? static_cast<uint32_t>(value) : UINT32_MAX;
+}
+
+// Simuliert höchstens `budget` Taktzyklen ab der aktuellen Taktgrenze und wartet dabei auf
+// eine steigende Flanke von ready. Die Simulation endet wie beim zyklenweisen sc_start(period)
+// immer auf einer Taktgrenze: nach der Flanke auf der nächsten, sonst nach `budget` Zyklen.
+// Gibt die Anzahl der simulierten Taktzyklen zurück.
+static uint32_t run_until_ready(READY_MONITOR *monitor, const sc_time &period, uint32_t budget)
+{
+    sc_time start = sc_time_stamp();
+    sc_time limit = budget > 0 ? period * budget : sc_max_time() - start;
+
+    monitor->fired = false;
+    monitor->armed = true;
+    profiledStart(limit);
+    monitor->armed = false;
+
+    if (!monitor->fired)
+    {
+        return budget;
+    }
+
+    uint32_t elapsed = static_cast<uint32_t>((sc_time_stamp() - start) / period) + 1;
+    profiledStart(start + period * elapsed - sc_time_stamp());
+    return elapsed;
+}
 
 struct Result run_simulation(
     uint32_t cycles,
@@ -13,86 +82,238 @@ struct Result run_simulation(
     uint32_t numRequests,
     struct Request *requests)
 {
-    struct Result result = {0, 0};
+    return run_simulation_ext(cycles, tracefile, latencyRom, romSize, blockSize, romContent, numRequests, requests, nullptr);
+}
 
-    sc_time period(10, SC_NS);
+// Netzliste des signalgenauen Modells mit Takt, Signalen und Modulen. run_simulation_ext() baut
+// sie für einen Lauf auf, eine SimSession (siehe sim_session.h) behält sie über viele Stapel von
+// Anfragen. SystemC kann nicht neu elaborieren, deshalb gibt es höchstens eine je Prozess.
+class SignalModel
+{
+public:
+    const sc_time period;
+    const struct SimOptions opts;
+    const uint32_t rom_limit; // Beginn des Hauptspeichers
 
-    sc_clock clk("clk", period);
+    sc_clock clk;
     sc_signal<uint32_t> addr, wdata, mem_rdata, rdata, mem_addr, mem_wdata;
     sc_signal<bool> r, w, wide, mem_ready, ready, error, mem_r, mem_w;
-    sc_signal<uint8_t> user;
+    sc_signal<uint8_t> user, mem_be;
+    // Zwischen Cache und Hauptspeicher, nur mit Cache belegt
+    sc_signal<uint32_t> ram_addr, ram_wdata, ram_rdata;
+    sc_signal<bool> ram_r, ram_w, ram_ready;
+    sc_signal<uint8_t> ram_be;
+
+    MEMORY_CONTROLLER *memory_controller;
+    MAIN_MEMORY *memory;
+    READY_MONITOR *ready_monitor;
+    MULTI_MASTER *masters = nullptr;
+    CACHE *cache = nullptr;
+    TraceWindow *trace = nullptr;
 
-    MEMORY_CONTROLLER *memory_controller = new MEMORY_CONTROLLER("memory_controller", romSize, romContent, latencyRom, blockSize);
-    MAIN_MEMORY *memory = new MAIN_MEMORY("Main_Memory", 3);
+    uint64_t total_cycles = 0; // aktueller Takt
+    uint64_t error_count = 0;
+    uint64_t completed = 0; // beantwortete Anfragen
+    double simulation_start = 0; // profile_now() am Ende der Elaboration
+    bool ram_ok = true;          // false: --ram file: konnte nicht eingeblendet werden
 
-    memory_controller->clk(clk);
-    memory_controller->addr(addr);
-    memory_controller->wdata(wdata);
-    memory_controller->mem_rdata(mem_rdata);
-    memory_controller->rdata(rdata);
-    memory_controller->mem_addr(mem_addr);
-    memory_controller->mem_wdata(mem_wdata);
-    memory_controller->r(r);
-    memory_controller->w(w);
-    memory_controller->wide(wide);
-    memory_controller->mem_ready(mem_ready);
-    memory_controller->ready(ready);
-    memory_controller->error(error);
-    memory_controller->mem_r(mem_r);
-    memory_controller->mem_w(mem_w);
-    memory_controller->user(user);
+    // requests/numRequests werden nur mit opts.split_users gebraucht (MULTI_MASTER).
+    SignalModel(const char *tracefile, uint32_t latencyRom, uint32_t romSize, uint32_t blockSize, uint32_t *romContent,
+                const struct SimOptions &options, uint32_t numRequests, struct Request *requests)
+        : period(10, SC_NS), opts(options), rom_limit((romSize + 3) & ~3u), clk("clk", period)
+    {
+        double start = profile_now();
+        memory_controller = new MEMORY_CONTROLLER("memory_controller", romSize, romContent, latencyRom, blockSize, opts.byte_enable,
+                                                  opts.rom_prefetch, opts.fsm, opts.store_buffer,
+                                                  opts.store_buffer_line > 0 ? opts.store_buffer_line : STORE_BUFFER_DEFAULT_LINE);
+        MemoryTiming::DramParams dram = MemoryTiming::paramsFrom(opts);
+        memory = new MAIN_MEMORY("Main_Memory", opts.latency_mem, opts.dram ? &dram : nullptr, opts.fsm);
+        ram_ok = configureRamStore(memory->memory, opts);
+        ready_monitor = new READY_MONITOR("ready_monitor");
+        ready_monitor->ready(ready);
 
-    memory->clk(clk);
-    memory->rdata(mem_rdata);
-    memory->addr(mem_addr);
-    memory->wdata(mem_wdata);
-    memory->ready(mem_ready);
-    memory->r(mem_r);
-    memory->w(mem_w);
+        memory_controller->clk(clk);
+        memory_controller->addr(addr);
+        memory_controller->wdata(wdata);
+        memory_controller->mem_rdata(mem_rdata);
+        memory_controller->rdata(rdata);
+        memory_controller->mem_addr(mem_addr);
+        memory_controller->mem_wdata(mem_wdata);
+        memory_controller->mem_be(mem_be);
+        memory_controller->r(r);
+        memory_controller->w(w);
+        memory_controller->wide(wide);
+        memory_controller->mem_ready(mem_ready);
+        memory_controller->ready(ready);
+        memory_controller->error(error);
+        memory_controller->mem_r(mem_r);
+        memory_controller->mem_w(mem_w);
+        memory_controller->user(user);
 
-    uint32_t total_cycles = 0;
-    uint32_t error_count = 0;
+        // Mit mehreren Mastern treibt MULTI_MASTER die Eingänge des Controllers statt request().
+        if (opts.split_users)
+        {
+            masters = new MULTI_MASTER("masters", requests, numRequests, opts, &memory_controller->schutz, rom_limit);
+            masters->clk(clk);
+            masters->addr(addr);
+            masters->wdata(wdata);
+            masters->r(r);
+            masters->w(w);
+            masters->wide(wide);
+            masters->user(user);
+            masters->ready(ready);
+            masters->error(error);
+        }
 
-    sc_trace_file *tf = nullptr;
-    if (tracefile != nullptr && strlen(tracefile) > 0)
-    {
-        std::string tfname(tracefile);
-        if (tfname.size() >= 4 && tfname.substr(tfname.size() - 4) == ".vcd")
+        memory->clk(clk);
+        if (opts.cache_size > 0)
+        {
+            cache = new CACHE("cache", opts.cache_size,
+                              opts.cache_line > 0 ? opts.cache_line : CACHE_DEFAULT_LINE,
+                              opts.cache_assoc > 0 ? opts.cache_assoc : CACHE_DEFAULT_ASSOC,
+                              static_cast<CacheArray::Replacement>(opts.cache_replacement),
+                              !opts.cache_write_through);
+            cache->clk(clk);
+            cache->addr(mem_addr);
+            cache->wdata(mem_wdata);
+            cache->be(mem_be);
+            cache->r(mem_r);
+            cache->w(mem_w);
+            cache->rdata(mem_rdata);
+            cache->ready(mem_ready);
+
+            cache->mem_addr(ram_addr);
+            cache->mem_wdata(ram_wdata);
+            cache->mem_be(ram_be);
+            cache->mem_r(ram_r);
+            cache->mem_w(ram_w);
+            cache->mem_rdata(ram_rdata);
+            cache->mem_ready(ram_ready);
+
+            memory->rdata(ram_rdata);
+            memory->addr(ram_addr);
+            memory->wdata(ram_wdata);
+            memory->be(ram_be);
+            memory->ready(ram_ready);
+            memory->r(ram_r);
+            memory->w(ram_w);
+        }
+        else
         {
-            tfname = tfname.substr(0, tfname.size() - 4); // 去除 ".vcd"
+            memory->rdata(mem_rdata);
+            memory->addr(mem_addr);
+            memory->wdata(mem_wdata);
+            memory->be(mem_be);
+            memory->ready(mem_ready);
+            memory->r(mem_r);
+            memory->w(mem_w);
         }
 
-        tf = sc_create_vcd_trace_file(tfname.c_str());
+        if (tracefile != nullptr && strlen(tracefile) > 0)
+        {
+            trace = new TraceWindow(tracefile, opts);
 
-        // Alle Signale anbinden
-        sc_trace(tf, clk, "clk");
+            // Alle Signale anmelden, aufgezeichnet werden nur die ausgewählten
+            trace->add(clk, "clk", nullptr);
 
-        sc_trace(tf, addr, "addr");
-        sc_trace(tf, wdata, "wdata");
-        sc_trace(tf, rdata, "rdata");
-        sc_trace(tf, mem_rdata, "mem_rdata");
-        sc_trace(tf, mem_addr, "mem_addr");
-        sc_trace(tf, mem_wdata, "mem_wdata");
+            trace->add(addr, "addr", "cu");
+            trace->add(wdata, "wdata", "cu");
+            trace->add(rdata, "rdata", "cu");
+            trace->add(mem_rdata, "mem_rdata", "mem");
+            trace->add(mem_addr, "mem_addr", "mem");
+            trace->add(mem_wdata, "mem_wdata", "mem");
+            if (opts.byte_enable)
+            {
+                trace->add(mem_be, "mem_be", "mem");
+            }
 
-        sc_trace(tf, r, "r");
-        sc_trace(tf, w, "w");
-        sc_trace(tf, wide, "wide");
-        sc_trace(tf, mem_ready, "mem_ready");
-        sc_trace(tf, ready, "ready");
-        sc_trace(tf, error, "error");
-        sc_trace(tf, mem_r, "mem_r");
-        sc_trace(tf, mem_w, "mem_w");
+            trace->add(r, "r", "cu");
+            trace->add(w, "w", "cu");
+            trace->add(wide, "wide", "cu");
+            trace->add(mem_ready, "mem_ready", "mem");
+            trace->add(ready, "ready", "cu");
+            trace->add(error, "error", "cu");
+            trace->add(mem_r, "mem_r", "mem");
+            trace->add(mem_w, "mem_w", "mem");
 
-        sc_trace(tf, user, "user");
+            trace->add(user, "user", "cu");
 
-        sc_trace(tf, memory->ready, "Memory_ready_signal");
-        sc_trace(tf, memory_controller->ready_cu_rom, "rom_ready");
+            trace->add(memory->ready, "Memory_ready_signal", "mem");
+            if (cache != nullptr)
+            {
+                trace->add(ram_addr, "ram_addr", "ram");
+                trace->add(ram_wdata, "ram_wdata", "ram");
+                trace->add(ram_rdata, "ram_rdata", "ram");
+                trace->add(ram_r, "ram_r", "ram");
+                trace->add(ram_w, "ram_w", "ram");
+            }
+            trace->add(memory_controller->ready_cu_rom, "rom_ready", "rom");
 
-        std::cout << "[TRACE] Tracing enabled: " << tfname << ".vcd\n";
+            trace->elaborate();
+            trace->update(0);
+        }
+        profile_add(opts.profile, PROFILE_ELABORATION, start);
+        simulation_start = profile_now();
+        profileStartSampling(opts.profile);
     }
-    for (std::size_t i = 0; i < numRequests; ++i)
+
+    // Nach dem Ende der Simulation: Die Prozesse laufen nicht mehr, die Module können wie am
+    // Ende von sc_main() abgebaut werden. Die Trace-Datei wird dabei geschlossen.
+    ~SignalModel()
     {
-        const Request &req = requests[i];
+        profile_add(opts.profile, PROFILE_SIMULATION, simulation_start);
+        profileCollect(opts.profile);
+        double start = profile_now();
+        delete trace;
+        profile_add(opts.profile, PROFILE_TRACE_CLOSE, start);
+        delete cache;
+        delete masters;
+        delete ready_monitor;
+        delete memory;
+        delete memory_controller;
+    }
+
+    // Läuft, bis alle Master fertig sind oder die Zyklengrenze (0 = keine) erreicht ist.
+    // Gibt false bei zu wenigen Taktzyklen zurück.
+    bool runMasters(uint32_t cycles)
+    {
+        uint32_t now = 0;
+        while (!masters->finished && (cycles == 0 || now < cycles))
+        {
+            uint32_t budget = cycles > 0 ? cycles - now : 0;
+            if (trace != nullptr)
+            {
+                budget = trace->limit(now, budget);
+            }
+            profiledStart(budget > 0 ? period * budget : sc_max_time() - sc_time_stamp());
+            now = static_cast<uint32_t>(sc_time_stamp() / period);
+            if (trace != nullptr)
+            {
+                trace->update(now);
+            }
+        }
+        error_count = masters->error_count;
+        if (!masters->finished)
+        {
+            LOG_ERROR(LOG_TB, "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt.");
+            total_cycles = cycles;
+            return false;
+        }
+        total_cycles = masters->finish_cycle;
+        return true;
+    }
+
+    // Stellt eine Anfrage und wartet auf ready. Gibt false zurück, wenn dabei die Zyklengrenze
+    // (0 = keine) erreicht wird.
+    bool request(const Request &req, uint32_t cycles)
+    {
+        uint64_t start_cycles = total_cycles;
+        uint64_t rejected_before = memory_controller->schutz.rejected;
+
+        if (trace != nullptr)
+        {
+            trace->onRequest(completed, req, total_cycles);
+        }
 
         // Eingangssignale setzen
         addr.write(req.addr);
@@ -103,40 +324,63 @@ struct Result run_simulation(
         user.write(req.user);
 
         // Debug Informationen
-        std::cout << "[" << sc_time_stamp() << "] "
-                  << (req.w ? "WRITE" : "READ") << " request: "
-                  << "addr=0x" << std::hex << req.addr
-                  << ", data=0x" << req.data
-                  << ", user=" << std::dec << (int)req.user
-                  << ", wide=" << (int)req.wide
-                  << std::endl;
+        LOG_DEBUG(LOG_TB, "[%s] %s request: addr=0x%x, data=0x%x, user=%d, wide=%d",
+                  sc_time_stamp().to_string().c_str(), req.w ? "WRITE" : "READ",
+                  req.addr, req.data, (int)req.user, (int)req.wide);
 
         // Simulation für einen Taktzyklus starten
-        sc_start(period); // Ein Taktzyklus: Signale an das Modul übergeben
+        profiledStart(period); // Ein Taktzyklus: Signale an das Modul übergeben
         total_cycles++;
+        if (trace != nullptr)
+        {
+            trace->update(total_cycles);
+        }
 
         if (total_cycles == cycles)
         {
-            std::cerr << "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt." << std::endl;
-            goto cycle_deficit;
+            LOG_ERROR(LOG_TB, "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt.");
+            return false;
         }
 
         while (!ready.read())
         {
-            sc_start(period); // Auf Modulantwort warten
-            total_cycles++;
+            // Auf Modulantwort warten, ohne jeden Zyklus einzeln zu starten
+            uint32_t budget = cycles > 0 ? static_cast<uint32_t>(cycles - total_cycles) : 0;
+            if (trace != nullptr)
+            {
+                budget = trace->limit(total_cycles, budget);
+            }
+            total_cycles += run_until_ready(ready_monitor, period, budget);
+            if (trace != nullptr)
+            {
+                trace->update(total_cycles);
+            }
             if (total_cycles == cycles)
             {
-                std::cerr << "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt." << std::endl;
-                goto cycle_deficit;
+                LOG_ERROR(LOG_TB, "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt.");
+                return false;
             }
         }
 
         if (error.read())
         {
-            std::cerr << " --> FEHLER: Modul hat einen Fehler bei der Anfrage gemeldet " << i << std::endl;
+            LOG_INFO(LOG_TB, " --> FEHLER: Modul hat einen Fehler bei der Anfrage gemeldet %llu",
+                     (unsigned long long)completed);
             error_count++;
         }
+        else if (!req.w)
+        {
+            // Gleiche Zeile wie im LT-Modell, testcase/regression.sh vergleicht die gelesenen Daten.
+            LOG_DEBUG(LOG_TB, "Anfrage %llu gelesen: 0x%08x", (unsigned long long)completed, rdata.read());
+        }
+
+        if (opts.stats != nullptr)
+        {
+            bool denied = memory_controller->schutz.rejected != rejected_before;
+            request_stats_record(opts.stats, request_class(&req, rom_limit, denied), req.user,
+                                 static_cast<uint32_t>(total_cycles - start_cycles));
+        }
+        completed++;
 
         // reset
         addr.write(0);
@@ -155,27 +399,259 @@ struct Result run_simulation(
         mem_w.write(false);
 
         user.write(0);
+        return true;
+    }
+
+    // Simuliert ohne Anfragen bis zum Takt end.
+    void runTo(uint64_t end)
+    {
+        while (total_cycles < end)
+        {
+            uint64_t rest = end - total_cycles;
+            uint32_t step = rest > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(rest);
+            // Mit Trace-Datei an den Grenzen des Fensters anhalten
+            if (trace != nullptr)
+            {
+                step = trace->limit(total_cycles, step);
+            }
+            profiledStart(period * step);
+            total_cycles += step;
+            if (trace != nullptr)
+            {
+                trace->update(total_cycles);
+            }
+        }
+    }
+
+    // Nach der letzten Anfrage: den Schreibpuffer leeren und geänderte Cachezeilen in den
+    // Hauptspeicher schreiben, damit das Abbild (--ram file:) vollständig ist. Die Takte dafür
+    // zählen nicht mehr zum Lauf.
+    void flush()
+    {
+        // Der Controller leert den Puffer im Leerlauf selbst; drainWord() entnimmt das Wort schon
+        // vor dem Speicherzugriff, daher auch auf das Ende von mem_w warten.
+        while (!memory_controller->store.empty() || mem_w.read())
+        {
+            profiledStart(period);
+        }
+        if (cache == nullptr)
+        {
+            return;
+        }
+        cache->requestFlush();
+        while (cache->flushPending())
+        {
+            profiledStart(period);
+        }
     }
 
-    // Die verbleibenden Taktzyklen ausführen
-    for (int i = total_cycles; i < cycles; i++)
+    // Zähler der Module in result übernehmen, mit log = true auch ausgeben
+    void collect(struct Result &result, bool log) const
     {
-        sc_start(period);
+        if (log)
+        {
+            LOG_INFO(LOG_MEM, "Belegte Speicherseiten (4 KiB): %u", memory->residentPages());
+            LOG_INFO(LOG_MC, "Blöcke zugeteilt: %llu, freigegeben: %llu, abgewiesene Zugriffe: %llu",
+                     (unsigned long long)memory_controller->schutz.gewalt.claimed,
+                     (unsigned long long)memory_controller->schutz.gewalt.released,
+                     (unsigned long long)memory_controller->schutz.gewalt.denied);
+        }
+        if (memory->timing.isDram())
+        {
+            if (log)
+            {
+                LOG_INFO(LOG_MEM, "DRAM: %llu Zeilentreffer, %llu Zugriffe auf geschlossene Bänke, %llu Zeilenkonflikte",
+                         (unsigned long long)memory->timing.row_hits, (unsigned long long)memory->timing.row_misses,
+                         (unsigned long long)memory->timing.row_conflicts);
+            }
+            result.dram_row_hits = static_cast<uint32_t>(memory->timing.row_hits);
+            result.dram_row_misses = static_cast<uint32_t>(memory->timing.row_misses);
+            result.dram_row_conflicts = static_cast<uint32_t>(memory->timing.row_conflicts);
+        }
+        memory_controller->rom->prefetch.report(result, log);
+        memory_controller->store.report(result, log);
+        if (cache != nullptr)
+        {
+            if (log)
+            {
+                LOG_INFO(LOG_MEM, "Cache: %u Treffer, %u Fehlzugriffe, %u Zeilen zurückgeschrieben",
+                         cache->lines.hits, cache->lines.misses, cache->lines.writebacks);
+            }
+            result.cache_hits = cache->lines.hits;
+            result.cache_misses = cache->lines.misses;
+            result.cache_writebacks = cache->lines.writebacks;
+        }
     }
+};
 
-cycle_deficit:
+struct Result run_simulation_ext(
+    uint32_t cycles,
+    const char *tracefile,
+    uint32_t latencyRom,
+    uint32_t romSize,
+    uint32_t blockSize,
+    uint32_t *romContent,
+    uint32_t numRequests,
+    struct Request *requests,
+    const struct SimOptions *options)
+{
+    struct Result result = {};
+    struct SimOptions opts = {};
+    if (options != nullptr)
+    {
+        opts = *options;
+    }
 
-    if (tf != nullptr)
+    SignalModel *model = new SignalModel(tracefile, latencyRom, romSize, blockSize, romContent, opts, numRequests, requests);
+    if (!model->ram_ok)
     {
-        sc_close_vcd_trace_file(tf);
+        delete model;
+        result.failed = 1;
+        return result;
+    }
+    bool complete = true;
+    if (model->masters != nullptr)
+    {
+        complete = model->runMasters(cycles);
+    }
+    else
+    {
+        // Ohne mehrere Master werden die Anfragen nacheinander gestellt.
+        for (uint32_t i = 0; complete && i < numRequests; ++i)
+        {
+            complete = model->request(requests[i], cycles);
+        }
     }
+    result.cycles = saturate32(model->total_cycles);
+    result.errors = saturate32(model->error_count);
 
-    result.cycles = total_cycles;
-    result.errors = error_count;
+    // Die verbleibenden Taktzyklen in einem Schritt ausführen
+    if (complete)
+    {
+        model->runTo(cycles);
+    }
 
+    model->collect(result, true);
+    if (complete)
+    {
+        model->flush();
+    }
+    delete model;
     return result;
 }
 
+struct SimSession
+{
+    SignalModel *model;
+    std::vector<struct Request> pending; // übergeben, noch nicht simuliert
+};
+
+// SystemC erlaubt nur eine Elaboration je Prozess.
+static bool session_used = false;
+
+struct SimSession *sim_session_create(const char *tracefile, uint32_t latencyRom, uint32_t romSize, uint32_t blockSize,
+                                      uint32_t *romContent, const struct SimOptions *options)
+{
+    struct SimOptions opts = {};
+    if (options != nullptr)
+    {
+        opts = *options;
+    }
+    if (session_used)
+    {
+        LOG_ERROR(LOG_TB, "Fehler: Je Prozess ist nur eine Sitzung möglich.");
+        return nullptr;
+    }
+    if (opts.split_users)
+    {
+        LOG_ERROR(LOG_TB, "Fehler: Sitzungen unterstützen keine getrennten Master (--split-users).");
+        return nullptr;
+    }
+    session_used = true;
+
+    SimSession *session = new SimSession();
+    session->model = new SignalModel(tracefile, latencyRom, romSize, blockSize, romContent, opts, 0, nullptr);
+    if (!session->model->ram_ok)
+    {
+        delete session->model;
+        delete session;
+        return nullptr;
+    }
+    return session;
+}
+
+int sim_session_submit(struct SimSession *session, const struct Request *requests, uint32_t count)
+{
+    session->pending.insert(session->pending.end(), requests, requests + count);
+    return 0;
+}
+
+int sim_session_run(struct SimSession *session)
+{
+    for (const Request &req : session->pending)
+    {
+        session->model->request(req, 0);
+    }
+    // Der Puffer behält seine Kapazität, der Speicherbedarf hängt nur von der Stapelgröße ab.
+    session->pending.clear();
+    return 0;
+}
+
+int sim_session_advance(struct SimSession *session, uint64_t cycles)
+{
+    if (!session->pending.empty())
+    {
+        LOG_ERROR(LOG_TB, "Fehler: Vor dem Weiterschalten müssen alle Anfragen simuliert sein.");
+        return 1;
+    }
+    session->model->runTo(session->model->total_cycles + cycles);
+    return 0;
+}
+
+int sim_session_stream(struct SimSession *session, request_source_fn source, void *context, uint32_t chunk)
+{
+    if (chunk == 0 || sim_session_run(session) != 0)
+    {
+        return 1;
+    }
+    std::vector<struct Request> buffer(chunk);
+    uint32_t count;
+    while ((count = source(context, buffer.data(), chunk)) > 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            session->model->request(buffer[i], 0);
+        }
+    }
+    return 0;
+}
+
+void sim_session_stats(const struct SimSession *session, struct SessionStats *stats)
+{
+    const SignalModel *model = session->model;
+    memset(stats, 0, sizeof(*stats));
+    stats->requests = model->completed;
+    stats->errors = model->error_count;
+    stats->cycles = model->total_cycles;
+    stats->pending = static_cast<uint32_t>(session->pending.size());
+    model->collect(stats->result, false);
+    stats->result.cycles = saturate32(model->total_cycles);
+    stats->result.errors = saturate32(model->error_count);
+}
+
+void sim_session_destroy(struct SimSession *session)
+{
+    if (session == nullptr)
+    {
+        return;
+    }
+    struct Result result = {};
+    session->model->collect(result, true);
+    session->model->flush();
+    delete session->model;
+    delete session;
+}
+
 int sc_main(int argc, char *argv[])
 {
     std::cout << "ERROR" << std::endl;
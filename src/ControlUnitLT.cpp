@@ -0,0 +1,202 @@
+#include <systemc.h>
+#include <tlm>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/tlm_quantumkeeper.h>
+
+#include "rahmenprogramm.h"
+#include "log.h"
+#include "latency_stats.h"
+#include "main_memory_lt.hpp"
+#include "memory_controller_lt.hpp"
+#include "sim_profile.hpp"
+
+// Takte, die die Testbench der Simulationszeit vorauslaufen darf, bevor sie synchronisiert
+#define LT_QUANTUM_CYCLES 10000
+
+// Testbench des LT-Modus: Schickt die Anfragen nacheinander per b_transport an den
+// Memory-Controller und zählt die annotierten Takte, ohne Taktsignal und ohne Delta-Zyklen.
+SC_MODULE(LT_TESTBENCH), public ActivityCounter
+{
+    tlm_utils::simple_initiator_socket<LT_TESTBENCH> socket;
+
+    uint32_t cycles;
+    uint32_t numRequests;
+    struct Request *requests;
+    sc_time period;
+    AccessControl *schutz;       // des Memory-Controllers, für die Einordnung abgewiesener Anfragen
+    uint32_t rom_limit;
+    struct RequestStats *stats;  // NULL = keine Statistik
+
+    uint32_t total_cycles;
+    uint32_t error_count;
+
+    SC_HAS_PROCESS(LT_TESTBENCH);
+
+    LT_TESTBENCH(sc_module_name name, uint32_t cycles, uint32_t numRequests, struct Request *requests, const sc_time &period,
+                 AccessControl *schutz, uint32_t rom_limit, struct RequestStats *stats)
+        : sc_module(name), socket("socket"), cycles(cycles), numRequests(numRequests), requests(requests), period(period),
+          schutz(schutz), rom_limit(rom_limit), stats(stats), total_cycles(0), error_count(0)
+    {
+        SC_THREAD(run);
+    }
+
+    void run()
+    {
+        tlm_utils::tlm_quantumkeeper quantum_keeper;
+        tlm::tlm_generic_payload trans;
+        UserExtension user_ext;
+        uint8_t data[4];
+
+        // Gewartet wird nur in quantum_keeper.sync(), der ganze Lauf zählt als eine Aktivierung.
+        activated();
+        quantum_keeper.reset();
+        trans.set_extension(&user_ext);
+
+        for (std::size_t i = 0; i < numRequests; ++i)
+        {
+            const Request &req = requests[i];
+
+            LOG_DEBUG(LOG_TB, "[%s] %s request: addr=0x%x, data=0x%x, user=%d, wide=%d",
+                      quantum_keeper.get_current_time().to_string().c_str(), req.w ? "WRITE" : "READ",
+                      req.addr, req.data, (int)req.user, (int)req.wide);
+
+            if (req.wide)
+            {
+                memcpy(data, &req.data, sizeof(req.data));
+            }
+            else
+            {
+                data[0] = req.data & 0xFF;
+            }
+            trans.set_command(req.w ? tlm::TLM_WRITE_COMMAND : tlm::TLM_READ_COMMAND);
+            trans.set_address(req.addr);
+            trans.set_data_ptr(data);
+            trans.set_data_length(req.wide ? 4 : 1);
+            trans.set_streaming_width(req.wide ? 4 : 1);
+            trans.set_byte_enable_ptr(nullptr);
+            trans.set_dmi_allowed(false);
+            trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+            user_ext.user = req.user;
+
+            uint64_t rejected_before = schutz->rejected;
+            sc_time delay = quantum_keeper.get_local_time();
+            socket->b_transport(trans, delay);
+            uint32_t needed = static_cast<uint32_t>((delay - quantum_keeper.get_local_time()) / period + 0.5);
+            quantum_keeper.set(delay);
+
+            // Wie im Signalmodell gilt eine Anfrage als unvollständig, wenn ihr letzter Takt
+            // die Zyklengrenze erreicht.
+            if (cycles > 0 && needed >= cycles - total_cycles)
+            {
+                total_cycles = cycles;
+                LOG_ERROR(LOG_TB, "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt.");
+                break;
+            }
+            total_cycles += needed;
+
+            if (trans.is_response_error())
+            {
+                LOG_INFO(LOG_TB, " --> FEHLER: Modul hat einen Fehler bei der Anfrage gemeldet %zu", i);
+                error_count++;
+            }
+            else if (!req.w)
+            {
+                uint32_t value = data[0];
+                if (req.wide)
+                {
+                    memcpy(&value, data, sizeof(value));
+                }
+                LOG_DEBUG(LOG_TB, "Anfrage %llu gelesen: 0x%08x", (unsigned long long)i, value);
+            }
+
+            if (stats != nullptr)
+            {
+                request_stats_record(stats, request_class(&req, rom_limit, schutz->rejected != rejected_before), req.user, needed);
+            }
+
+            if (quantum_keeper.need_sync())
+            {
+                quantum_keeper.sync();
+            }
+        }
+
+        trans.clear_extension(&user_ext);
+    }
+};
+
+struct Result run_simulation_lt(
+    uint32_t cycles,
+    const char *tracefile,
+    uint32_t latencyRom,
+    uint32_t romSize,
+    uint32_t blockSize,
+    uint32_t *romContent,
+    uint32_t numRequests,
+    struct Request *requests,
+    const struct SimOptions *options)
+{
+    struct Result result = {};
+    struct SimOptions opts = {};
+    if (options != nullptr)
+    {
+        opts = *options;
+    }
+    double start = profile_now();
+
+    sc_time period(10, SC_NS);
+
+    if (tracefile != nullptr && strlen(tracefile) > 0)
+    {
+        LOG_WARN(LOG_TB, "Im LT-Modus gibt es keine Signale, die Trace-Datei %s wird nicht geschrieben.", tracefile);
+    }
+
+    tlm::tlm_global_quantum::instance().set(period * LT_QUANTUM_CYCLES);
+
+    MEMORY_CONTROLLER_LT *memory_controller = new MEMORY_CONTROLLER_LT("memory_controller", romSize, romContent, latencyRom, blockSize, period, opts.byte_enable,
+                                                                       opts.rom_prefetch);
+    MemoryTiming::DramParams dram = MemoryTiming::paramsFrom(opts);
+    MAIN_MEMORY_LT *memory = new MAIN_MEMORY_LT("Main_Memory", opts.latency_mem, period, opts.byte_enable, opts.dram ? &dram : nullptr);
+    if (!configureRamStore(memory->memory, opts))
+    {
+        result.failed = 1;
+        return result;
+    }
+    LT_TESTBENCH *testbench = new LT_TESTBENCH("testbench", cycles, numRequests, requests, period,
+                                                &memory_controller->schutz, (romSize + 3) & ~3u, opts.stats);
+
+    testbench->socket.bind(memory_controller->socket);
+    memory_controller->mem_socket.bind(memory->socket);
+
+    profile_add(opts.profile, PROFILE_ELABORATION, start);
+    start = profile_now();
+    profileStartSampling(opts.profile);
+
+    // Läuft, bis die Testbench alle Anfragen abgearbeitet hat
+    profiledStart();
+
+    profile_add(opts.profile, PROFILE_SIMULATION, start);
+    profileCollect(opts.profile);
+
+    LOG_INFO(LOG_MEM, "Belegte Speicherseiten (4 KiB): %u", memory->residentPages());
+    LOG_INFO(LOG_MC, "Blöcke zugeteilt: %llu, freigegeben: %llu, abgewiesene Zugriffe: %llu",
+             (unsigned long long)memory_controller->schutz.gewalt.claimed,
+             (unsigned long long)memory_controller->schutz.gewalt.released,
+             (unsigned long long)memory_controller->schutz.gewalt.denied);
+
+    if (memory->timing.isDram())
+    {
+        LOG_INFO(LOG_MEM, "DRAM: %llu Zeilentreffer, %llu Zugriffe auf geschlossene Bänke, %llu Zeilenkonflikte",
+                 (unsigned long long)memory->timing.row_hits, (unsigned long long)memory->timing.row_misses,
+                 (unsigned long long)memory->timing.row_conflicts);
+        result.dram_row_hits = static_cast<uint32_t>(memory->timing.row_hits);
+        result.dram_row_misses = static_cast<uint32_t>(memory->timing.row_misses);
+        result.dram_row_conflicts = static_cast<uint32_t>(memory->timing.row_conflicts);
+    }
+    memory_controller->rom->prefetch.report(result);
+
+    // Der Leerlauf bis zur Zyklengrenze ändert das Ergebnis nicht und wird nicht simuliert.
+    result.cycles = testbench->total_cycles;
+    result.errors = testbench->error_count;
+
+    return result;
+}
@@ -0,0 +1,324 @@
+#include <systemc.h>
+
+#include "rahmenprogramm.h"
+#include "log.h"
+#include "latency_stats.h"
+#include "memory_timing.hpp"
+#include "pipelined_controller.hpp"
+#include "pipelined_memory.hpp"
+#include "sim_profile.hpp"
+#include "trace_window.hpp"
+
+// Stellt die Anfragen ohne Pause nacheinander (Handshake req_valid/req_ready) und sammelt die
+// Antworten ein, die auch außer der Reihe kommen dürfen. Der Tag einer Anfrage ist ihr Index
+// modulo 256; da höchstens PIPELINE_MAX_OUTSTANDING Anfragen offen sind, ist er eindeutig.
+SC_MODULE(PIPELINED_TESTBENCH), public ActivityCounter
+{
+    sc_in<bool> clk;
+
+    sc_out<bool> req_valid, req_w, req_wide;
+    sc_out<uint32_t> req_addr, req_wdata;
+    sc_out<uint8_t> req_user, req_tag;
+    sc_in<bool> req_ready;
+
+    sc_in<bool> resp_valid, resp_error;
+    sc_in<uint8_t> resp_tag;
+
+    bool finished;
+    uint32_t finish_cycle; // Takt, in dem die letzte Antwort gesehen wurde
+    uint32_t error_count;
+
+    SC_HAS_PROCESS(PIPELINED_TESTBENCH);
+    // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+    PROFILED_WAIT
+
+    // controller: für die Einordnung abgewiesener Anfragen in stats (darf NULL sein)
+    PIPELINED_TESTBENCH(sc_module_name name, const struct Request *requests, uint32_t num_requests,
+                        const PIPELINED_CONTROLLER *controller, uint32_t rom_limit, struct RequestStats *stats)
+        : sc_module(name), finished(false), finish_cycle(0), error_count(0), requests(requests),
+          num_requests(num_requests), controller(controller), rom_limit(rom_limit), stats(stats)
+    {
+        SC_THREAD(run);
+        sensitive << clk.pos();
+    }
+
+private:
+    const struct Request *requests;
+    uint32_t num_requests;
+    const PIPELINED_CONTROLLER *controller;
+    uint32_t rom_limit;
+    struct RequestStats *stats;
+
+    uint32_t issue_index[256] = {};
+    uint32_t issue_cycle[256] = {};
+
+    void run()
+    {
+        uint32_t cycle = 0;
+        uint32_t next = 0; // nächste noch nicht angenommene Anfrage
+        uint32_t done = 0;
+        bool presenting = false;
+
+        while (true)
+        {
+            wait();
+            cycle++;
+
+            // Werte der vorigen Flanke: Antwort des Controllers und Annahme der angelegten Anfrage
+            if (resp_valid.read())
+            {
+                uint8_t tag = resp_tag.read();
+                const Request &req = requests[issue_index[tag]];
+                if (resp_error.read())
+                {
+                    LOG_INFO(LOG_TB, " --> FEHLER: Modul hat einen Fehler bei der Anfrage gemeldet %u", issue_index[tag]);
+                    error_count++;
+                }
+                if (stats != nullptr)
+                {
+                    bool denied = controller != nullptr && controller->denied[tag];
+                    request_stats_record(stats, request_class(&req, rom_limit, denied), req.user, cycle - issue_cycle[tag]);
+                }
+                done++;
+                finish_cycle = cycle;
+            }
+            if (presenting && req_ready.read())
+            {
+                presenting = false;
+                next++;
+            }
+
+            if (done == num_requests)
+            {
+                req_valid.write(false);
+                finished = true;
+                sc_pause();
+                continue;
+            }
+
+            if (!presenting && next < num_requests)
+            {
+                const Request &req = requests[next];
+                uint8_t tag = static_cast<uint8_t>(next & 0xFF);
+                LOG_DEBUG(LOG_TB, "[%s] %s request %u: addr=0x%x, data=0x%x, user=%d, wide=%d",
+                          sc_time_stamp().to_string().c_str(), req.w ? "WRITE" : "READ", next,
+                          req.addr, req.data, (int)req.user, (int)req.wide);
+                req_addr.write(req.addr);
+                req_wdata.write(req.data);
+                req_w.write(req.w);
+                req_wide.write(req.wide);
+                req_user.write(req.user);
+                req_tag.write(tag);
+                req_valid.write(true);
+                issue_index[tag] = next;
+                issue_cycle[tag] = cycle;
+                presenting = true;
+            }
+            else if (!presenting)
+            {
+                req_valid.write(false);
+            }
+        }
+    }
+};
+
+struct Result run_simulation_pipelined(
+    uint32_t cycles,
+    const char *tracefile,
+    uint32_t latencyRom,
+    uint32_t romSize,
+    uint32_t blockSize,
+    uint32_t *romContent,
+    uint32_t numRequests,
+    struct Request *requests,
+    const struct SimOptions *options)
+{
+    struct Result result = {};
+    struct SimOptions opts = {};
+    if (options != nullptr)
+    {
+        opts = *options;
+    }
+    double start = profile_now();
+
+    sc_time period(10, SC_NS);
+
+    sc_clock clk("clk", period);
+    sc_signal<bool> req_valid, req_w, req_wide, req_ready, resp_valid, resp_error;
+    sc_signal<uint32_t> req_addr, req_wdata, resp_rdata;
+    sc_signal<uint8_t> req_user, req_tag, resp_tag;
+    sc_signal<bool> mem_valid, mem_write, mem_resp_valid;
+    sc_signal<uint8_t> mem_tag, mem_be, mem_resp_tag;
+    sc_signal<uint32_t> mem_addr, mem_wdata, mem_resp_rdata;
+
+    uint32_t outstanding = opts.outstanding > 0 ? opts.outstanding : PIPELINE_DEFAULT_OUTSTANDING;
+    if (outstanding > PIPELINE_MAX_OUTSTANDING)
+    {
+        outstanding = PIPELINE_MAX_OUTSTANDING;
+    }
+    uint32_t rom_limit = (romSize + 3) & ~3u;
+
+    PIPELINED_CONTROLLER *controller = new PIPELINED_CONTROLLER("memory_controller", romSize, romContent, latencyRom,
+                                                                blockSize, outstanding, !opts.out_of_order,
+                                                                opts.rom_prefetch);
+    MemoryTiming::DramParams dram = MemoryTiming::paramsFrom(opts);
+    PIPELINED_MEMORY *memory = new PIPELINED_MEMORY("Main_Memory", opts.latency_mem, opts.dram ? &dram : nullptr);
+    if (!configureRamStore(memory->memory, opts))
+    {
+        result.failed = 1;
+        return result;
+    }
+    PIPELINED_TESTBENCH *testbench = new PIPELINED_TESTBENCH("testbench", requests, numRequests, controller,
+                                                             rom_limit, opts.stats);
+
+    testbench->clk(clk);
+    testbench->req_valid(req_valid);
+    testbench->req_w(req_w);
+    testbench->req_wide(req_wide);
+    testbench->req_addr(req_addr);
+    testbench->req_wdata(req_wdata);
+    testbench->req_user(req_user);
+    testbench->req_tag(req_tag);
+    testbench->req_ready(req_ready);
+    testbench->resp_valid(resp_valid);
+    testbench->resp_error(resp_error);
+    testbench->resp_tag(resp_tag);
+
+    controller->clk(clk);
+    controller->req_valid(req_valid);
+    controller->req_w(req_w);
+    controller->req_wide(req_wide);
+    controller->req_addr(req_addr);
+    controller->req_wdata(req_wdata);
+    controller->req_user(req_user);
+    controller->req_tag(req_tag);
+    controller->req_ready(req_ready);
+    controller->resp_valid(resp_valid);
+    controller->resp_error(resp_error);
+    controller->resp_tag(resp_tag);
+    controller->resp_rdata(resp_rdata);
+    controller->mem_valid(mem_valid);
+    controller->mem_write(mem_write);
+    controller->mem_tag(mem_tag);
+    controller->mem_be(mem_be);
+    controller->mem_addr(mem_addr);
+    controller->mem_wdata(mem_wdata);
+    controller->mem_resp_valid(mem_resp_valid);
+    controller->mem_resp_tag(mem_resp_tag);
+    controller->mem_resp_rdata(mem_resp_rdata);
+
+    memory->clk(clk);
+    memory->cmd_valid(mem_valid);
+    memory->cmd_write(mem_write);
+    memory->cmd_tag(mem_tag);
+    memory->cmd_be(mem_be);
+    memory->cmd_addr(mem_addr);
+    memory->cmd_wdata(mem_wdata);
+    memory->resp_valid(mem_resp_valid);
+    memory->resp_tag(mem_resp_tag);
+    memory->resp_rdata(mem_resp_rdata);
+
+    TraceWindow *trace = nullptr;
+    if (tracefile != nullptr && strlen(tracefile) > 0)
+    {
+        trace = new TraceWindow(tracefile, opts);
+
+        trace->add(clk, "clk", nullptr);
+
+        trace->add(req_valid, "req_valid", "cu");
+        trace->add(req_ready, "req_ready", "cu");
+        trace->add(req_w, "req_w", "cu");
+        trace->add(req_wide, "req_wide", "cu");
+        trace->add(req_addr, "req_addr", "cu");
+        trace->add(req_wdata, "req_wdata", "cu");
+        trace->add(req_user, "req_user", "cu");
+        trace->add(req_tag, "req_tag", "cu");
+        trace->add(resp_valid, "resp_valid", "cu");
+        trace->add(resp_error, "resp_error", "cu");
+        trace->add(resp_tag, "resp_tag", "cu");
+        trace->add(resp_rdata, "resp_rdata", "cu");
+
+        trace->add(mem_valid, "mem_valid", "mem");
+        trace->add(mem_write, "mem_write", "mem");
+        trace->add(mem_tag, "mem_tag", "mem");
+        trace->add(mem_be, "mem_be", "mem");
+        trace->add(mem_addr, "mem_addr", "mem");
+        trace->add(mem_wdata, "mem_wdata", "mem");
+        trace->add(mem_resp_valid, "mem_resp_valid", "mem");
+        trace->add(mem_resp_tag, "mem_resp_tag", "mem");
+        trace->add(mem_resp_rdata, "mem_resp_rdata", "mem");
+
+        trace->elaborate();
+        trace->update(0);
+    }
+    profile_add(opts.profile, PROFILE_ELABORATION, start);
+    start = profile_now();
+    profileStartSampling(opts.profile);
+
+    // Läuft, bis alle Antworten da sind oder die Zyklengrenze erreicht ist
+    uint32_t now = 0;
+    while (!testbench->finished && (cycles == 0 || now < cycles))
+    {
+        uint32_t budget = cycles > 0 ? cycles - now : 0;
+        if (trace != nullptr)
+        {
+            budget = trace->limit(now, budget);
+        }
+        profiledStart(budget > 0 ? period * budget : sc_max_time() - sc_time_stamp());
+        now = static_cast<uint32_t>(sc_time_stamp() / period);
+        if (trace != nullptr)
+        {
+            trace->update(now);
+        }
+    }
+
+    uint32_t total_cycles = testbench->finish_cycle;
+    if (!testbench->finished)
+    {
+        LOG_ERROR(LOG_TB, "Fehler: Unzureichende Taktzyklen, Befehl nicht vollständig ausgeführt.");
+        total_cycles = cycles;
+    }
+    else
+    {
+        // Die verbleibenden Taktzyklen in einem Schritt ausführen
+        while (now < cycles)
+        {
+            uint32_t step = trace != nullptr ? trace->limit(now, cycles - now) : cycles - now;
+            profiledStart(period * step);
+            now += step;
+            if (trace != nullptr)
+            {
+                trace->update(now);
+            }
+        }
+    }
+
+    LOG_INFO(LOG_MC, "Höchstens %u Anfragen gleichzeitig offen, %u Befehle gleichzeitig im Hauptspeicher",
+             controller->max_outstanding, memory->max_in_flight);
+    LOG_INFO(LOG_MEM, "Belegte Speicherseiten (4 KiB): %u", memory->residentPages());
+    LOG_INFO(LOG_MC, "Blöcke zugeteilt: %llu, freigegeben: %llu, abgewiesene Zugriffe: %llu",
+             (unsigned long long)controller->schutz.gewalt.claimed,
+             (unsigned long long)controller->schutz.gewalt.released,
+             (unsigned long long)controller->schutz.gewalt.denied);
+    if (memory->timing.isDram())
+    {
+        LOG_INFO(LOG_MEM, "DRAM: %llu Zeilentreffer, %llu Zugriffe auf geschlossene Bänke, %llu Zeilenkonflikte",
+                 (unsigned long long)memory->timing.row_hits, (unsigned long long)memory->timing.row_misses,
+                 (unsigned long long)memory->timing.row_conflicts);
+        result.dram_row_hits = static_cast<uint32_t>(memory->timing.row_hits);
+        result.dram_row_misses = static_cast<uint32_t>(memory->timing.row_misses);
+        result.dram_row_conflicts = static_cast<uint32_t>(memory->timing.row_conflicts);
+    }
+    controller->prefetch.report(result);
+
+    profile_add(opts.profile, PROFILE_SIMULATION, start);
+    profileCollect(opts.profile);
+    start = profile_now();
+    delete trace;
+    profile_add(opts.profile, PROFILE_TRACE_CLOSE, start);
+
+    result.cycles = total_cycles;
+    result.errors = testbench->error_count;
+
+    return result;
+}
@@ -0,0 +1,94 @@
+#ifndef ACCESS_CONTROL_HPP
+#define ACCESS_CONTROL_HPP
+
+#include <cstdint>
+
+#include "block_owner_table.hpp"
+#include "log.h"
+
+// Zugriffsschutz des Memory-Controllers: ROM ist nur lesbar, Blöcke oberhalb des ROMs gehören
+// dem ersten Benutzer, der sie beschreibt. Wird vom signalgenauen und vom LT-Modell verwendet.
+class AccessControl
+{
+public:
+    // Besitzer je Block oberhalb des ROMs
+    BlockOwnerTable gewalt;
+
+    // Alle abgewiesenen Zugriffe, auch Schreibzugriffe auf den ROM
+    uint64_t rejected = 0;
+
+    // rom_size: Größe aus der Konfiguration, rom_limit: tatsächliche (aufgerundete) ROM-Größe
+    AccessControl(uint32_t rom_size, uint32_t rom_limit, uint32_t block_size)
+        : gewalt((static_cast<uint64_t>(UINT32_MAX) - rom_size) / block_size + 1),
+          rom_size(rom_size), rom_limit(rom_limit), block_size(block_size)
+    {
+    }
+
+    bool check(uint32_t adresse, uint8_t benutzer, bool schreiben)
+    {
+        if (adresse < rom_limit)
+        {
+            if (schreiben)
+            {
+                LOG_INFO(LOG_MC, "Fehler: Schreibzugriff auf ROM-Adresse 0x%08X ist verboten.", adresse);
+                rejected++;
+                return false;
+            }
+            // Jeder darf ROM lesen
+        }
+        else
+        {
+            // Berechnung der Startadresse des zugehörigen Blocks
+            uint32_t block_addr = (adresse - rom_size) / block_size;
+
+            // Der Superuser hat immer alle Berechtigungen.
+            if (benutzer == 0)
+            {
+                return true;
+            }
+            else if (benutzer == 255)
+            {
+                gewalt.release(block_addr);
+                return true;
+            }
+
+            uint8_t besitzer = gewalt.owner(block_addr);
+            if (besitzer == BlockOwnerTable::NO_OWNER)
+            {
+                // Dieser Block hat noch keinen Besitzer – jeder darf darauf zugreifen.
+                if (!schreiben)
+                {
+                    LOG_DEBUG(LOG_MC, "ACHTUNG : Block 0x%08X wird noch nicht geschrieben.", block_addr);
+                    return true;
+                }
+                gewalt.claim(block_addr, benutzer);
+                LOG_INFO(LOG_MC, "Block 0x%08X wurde User %u zugeteilt.", block_addr, benutzer);
+                return true;
+            }
+
+            if (besitzer != benutzer)
+            {
+                gewalt.denied++;
+                rejected++;
+                LOG_INFO(LOG_MC, "User %u hat keine Berechtigung auf Block 0x%08X (Adresse 0x%08X).", benutzer, block_addr, adresse);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Liefert 255, wenn der Block keinen Besitzer hat.
+    uint8_t getOwner(uint32_t adresse) const
+    {
+        uint32_t block_addr = (adresse - rom_size) / block_size;
+        uint8_t besitzer = gewalt.owner(block_addr);
+        return besitzer != BlockOwnerTable::NO_OWNER ? besitzer : 255;
+    }
+
+private:
+    uint32_t rom_size;
+    uint32_t rom_limit;
+    uint32_t block_size;
+};
+
+#endif // ACCESS_CONTROL_HPP
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "bench.h"
+#include "workload.h"
+#include "rom_loader.h"
+#include "log.h"
+
+// Höchstzahl der Lasten in einer --bench-Liste
+#define BENCH_MAX_WORKLOADS 64
+
+// Ergebnis eines Laufs im gemeinsam genutzten Speicher
+struct BenchRun
+{
+    int status; // 0 = ok, sonst fehlgeschlagen
+    double seconds;
+    struct Result result;
+};
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Läuft im Kindprozess: Anfragen erzeugen und simulieren. Gemessen wird nur die Simulation,
+// der Speicher für die Anfragen zählt zum RSS.
+static void run_one(const MemConfig *config, simulate_fn simulate, const struct WorkloadSpec *spec,
+                    struct BenchRun *run)
+{
+    freopen("/dev/null", "w", stdout);
+    freopen("/dev/null", "w", stderr);
+    log_set_levels("off");
+
+    struct RomContent rom = {0};
+    if (config->rom_content_file != NULL &&
+        rom_load(config->rom_content_file, config->rom_size, config->rom_format, &rom) != 0)
+    {
+        _exit(1);
+    }
+    struct Request *requests = NULL;
+    if (workload_generate(spec, &requests) != 0)
+    {
+        _exit(1);
+    }
+
+    double start = now_seconds();
+    run->result = simulate(0, NULL, config->latency_rom, config->rom_size, config->block_size, rom.words,
+                           spec->count, requests, &config->options);
+    run->seconds = now_seconds() - start;
+    run->status = 0;
+    _exit(0);
+}
+
+int run_bench(const MemConfig *config, simulate_fn simulate, const char *workloads, const struct SweepList *sizes)
+{
+    if (config->options.ram_file != NULL)
+    {
+        fprintf(stderr, "Fehler: --ram file: geht nicht mit --bench.\n");
+        return 1;
+    }
+    struct WorkloadSpec specs[BENCH_MAX_WORKLOADS];
+    uint32_t num_specs = 0;
+    char *list = strdup(workloads);
+    if (list == NULL)
+    {
+        return 1;
+    }
+    char *saveptr = NULL;
+    for (char *item = strtok_r(list, ";", &saveptr); item != NULL; item = strtok_r(NULL, ";", &saveptr))
+    {
+        if (num_specs == BENCH_MAX_WORKLOADS)
+        {
+            fprintf(stderr, "Fehler: Mehr als %d Lasten für --bench.\n", BENCH_MAX_WORKLOADS);
+            free(list);
+            return 1;
+        }
+        if (workload_parse(item, config->rom_size, &specs[num_specs]) != 0)
+        {
+            free(list);
+            return 1;
+        }
+        num_specs++;
+    }
+    free(list);
+    if (num_specs == 0)
+    {
+        fprintf(stderr, "Fehler: Keine Last für --bench angegeben.\n");
+        return 1;
+    }
+
+    struct BenchRun *run = mmap(NULL, sizeof(*run), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (run == MAP_FAILED)
+    {
+        fprintf(stderr, "Fehler: Kein gemeinsamer Speicher für den Benchmark.\n");
+        return 1;
+    }
+
+    // Die Läufe laufen nacheinander, damit sie sich nicht um CPU und Speicherbandbreite streiten.
+    printf("Last         Anfragen   Sekunden  Anfragen/s  Takte/Anfrage  Max. RSS (MiB)\n");
+    fflush(NULL);
+    uint32_t failed = 0;
+    for (uint32_t w = 0; w < num_specs; w++)
+    {
+        for (uint32_t s = 0; s < sizes->count; s++)
+        {
+            struct WorkloadSpec spec = specs[w];
+            spec.count = sizes->values[s];
+            memset(run, 0, sizeof(*run));
+            run->status = 1;
+
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                run_one(config, simulate, &spec, run);
+            }
+            int status = 0;
+            struct rusage usage;
+            memset(&usage, 0, sizeof(usage));
+            if (pid < 0 || wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0 ||
+                run->status != 0)
+            {
+                printf("%-10s %10u  fehlgeschlagen\n", workload_name(spec.pattern), spec.count);
+                failed++;
+                continue;
+            }
+            // ru_maxrss ist unter Linux in KiB angegeben
+            printf("%-10s %10u %10.3f %11.0f %14.2f %15.1f\n", workload_name(spec.pattern), spec.count, run->seconds,
+                   run->seconds > 0 ? spec.count / run->seconds : 0.0,
+                   spec.count > 0 ? (double)run->result.cycles / spec.count : 0.0, usage.ru_maxrss / 1024.0);
+            fflush(stdout);
+        }
+    }
+
+    munmap(run, sizeof(*run));
+    if (failed > 0)
+    {
+        fprintf(stderr, "Benchmark: %u Läufe fehlgeschlagen.\n", failed);
+        return 1;
+    }
+    return 0;
+}
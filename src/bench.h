@@ -0,0 +1,26 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include "rahmenprogramm.h"
+#include "sweep.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // Simuliert jede synthetische Last aus `workloads` (Textform wie bei --workload, getrennt
+    // durch ';') mit jeder Anzahl aus `sizes` nacheinander in je einem Kindprozess und gibt
+    // Anfragen je Sekunde (Host), simulierte Takte je Anfrage und den höchsten RSS des
+    // Kindprozesses als Tabelle auf stdout aus. Eine Angabe n= in der Last wird durch die
+    // jeweilige Anzahl ersetzt. Die übrigen Parameter kommen aus config, ohne Taktgrenze;
+    // --ram file: (options.ram_file) wird wie bei run_sweep() abgelehnt.
+    // Gibt 0 zurück, wenn alle Läufe erfolgreich waren.
+    int run_bench(const MemConfig *config, simulate_fn simulate, const char *workloads, const struct SweepList *sizes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H
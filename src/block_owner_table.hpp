@@ -0,0 +1,79 @@
+#ifndef BLOCK_OWNER_TABLE_HPP
+#define BLOCK_OWNER_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Besitzer je Speicherblock, ein Byte pro Block und direkt über den Blockindex adressiert.
+// Die Tabelle ist in Regionen zu 64 Ki Blöcken aufgeteilt, die erst beim ersten Besitzer
+// in der Region angelegt werden. Da User 0 und 255 nie Besitzer werden, steht 0 für "frei".
+class BlockOwnerTable
+{
+public:
+    static const uint8_t NO_OWNER = 0;
+    static const uint32_t REGION_BITS = 16;
+    static const uint32_t REGION_SIZE = 1u << REGION_BITS;
+
+    uint64_t claimed = 0;  // Blöcke, die einem Benutzer zugeteilt wurden
+    uint64_t released = 0; // Blöcke, die durch User 255 wieder freigegeben wurden
+    uint64_t denied = 0;   // abgewiesene Zugriffe auf fremde Blöcke
+
+    // num_blocks: Anzahl der Blöcke oberhalb des ROMs (höchstens 2^32)
+    explicit BlockOwnerTable(uint64_t num_blocks)
+        : regions((num_blocks + REGION_SIZE - 1) >> REGION_BITS)
+    {
+    }
+
+    uint8_t owner(uint32_t block) const
+    {
+        uint32_t region = block >> REGION_BITS;
+        if (region >= regions.size() || !regions[region])
+        {
+            return NO_OWNER;
+        }
+        return regions[region][block & (REGION_SIZE - 1)];
+    }
+
+    void claim(uint32_t block, uint8_t user)
+    {
+        std::unique_ptr<uint8_t[]> &table = regions.at(block >> REGION_BITS);
+        if (!table)
+        {
+            table.reset(new uint8_t[REGION_SIZE]());
+        }
+        table[block & (REGION_SIZE - 1)] = user;
+        claimed++;
+    }
+
+    void release(uint32_t block)
+    {
+        uint32_t region = block >> REGION_BITS;
+        if (region >= regions.size() || !regions[region])
+        {
+            return;
+        }
+        uint8_t &entry = regions[region][block & (REGION_SIZE - 1)];
+        if (entry != NO_OWNER)
+        {
+            entry = NO_OWNER;
+            released++;
+        }
+    }
+
+    // Anzahl der angelegten Regionen
+    uint32_t residentRegions() const
+    {
+        uint32_t count = 0;
+        for (const auto &table : regions)
+        {
+            count += table ? 1 : 0;
+        }
+        return count;
+    }
+
+private:
+    std::vector<std::unique_ptr<uint8_t[]>> regions;
+};
+
+#endif // BLOCK_OWNER_TABLE_HPP
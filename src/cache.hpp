@@ -0,0 +1,272 @@
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <systemc>
+
+#include "cache_array.hpp"
+#include "log.h"
+#include "sim_profile.hpp"
+using namespace sc_core;
+
+// Satzassoziativer Cache zwischen den mem_*-Ports des Memory-Controllers und MAIN_MEMORY.
+// Zum Controller hin verhält er sich wie MAIN_MEMORY (gleiche Ports, gleicher Handshake), nur
+// dass ein Treffer nach HIT_LATENCY Takten beantwortet wird, direkt im Taktprozess und ohne
+// zusätzliche Delta-Zyklen. Fehlzugriffe laden die Zeile wortweise aus dem Hauptspeicher.
+// Der Zugriffsschutz bleibt unberührt: protection() prüft jede Anfrage, bevor sie die mem_*-Ports
+// erreicht, und ROM-Adressen kommen hier nie an. Die Besitzer der Blöcke ändern nichts an den
+// Daten, daher muss beim Freigeben eines Blocks auch nichts invalidiert werden.
+// Geänderte Zeilen (Write-Back) landen erst beim Verdrängen im Hauptspeicher; nach der letzten
+// Anfrage schreibt requestFlush() die übrigen zurück.
+SC_MODULE(CACHE), public ActivityCounter
+{
+  static const uint32_t HIT_LATENCY = 1;
+
+  sc_in<bool> clk;
+
+  // Seite des Memory-Controllers
+  sc_in<uint32_t> addr;
+  sc_in<uint32_t> wdata;
+  sc_in<uint8_t> be;
+  sc_in<bool> r;
+  sc_in<bool> w;
+  sc_out<uint32_t> rdata;
+  sc_out<bool> ready{"ready_in_Cache"};
+
+  // Seite des Hauptspeichers
+  sc_out<uint32_t> mem_addr, mem_wdata;
+  sc_out<uint8_t> mem_be;
+  sc_out<bool> mem_r, mem_w;
+  sc_in<uint32_t> mem_rdata;
+  sc_in<bool> mem_ready;
+
+  CacheArray lines;
+  // Write-Back mit Write-Allocate, sonst Write-Through ohne Write-Allocate
+  bool write_back;
+
+  SC_HAS_PROCESS(CACHE);
+  // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+  PROFILED_WAIT
+
+  CACHE(sc_module_name name, uint32_t size, uint32_t line_size, uint32_t assoc, CacheArray::Replacement replacement, bool write_back)
+      : sc_module(name), lines(size, line_size, assoc, replacement), write_back(write_back)
+  {
+    SC_THREAD(behaviour);
+    sensitive << clk.pos();
+  }
+
+  void behaviour()
+  {
+    // Wie MAIN_MEMORY führt der Cache ein nach ready noch anliegendes w ein zweites Mal aus.
+    // Diese Wiederholung wird nicht in der Statistik gezählt.
+    bool write_held = false;
+    while (true)
+    {
+      wait();
+
+      bool repeated = write_held && w.read();
+      write_held = false;
+      if (flush_pending && !r.read() && !w.read())
+      {
+        writeBackAll();
+        flush_pending = false;
+        continue;
+      }
+      if (r.read())
+      {
+        doRead(w.read());
+      }
+      if (w.read())
+      {
+        doWrite(!repeated);
+        write_held = true;
+      }
+    }
+  }
+
+  void doRead(bool dontSetReady)
+  {
+    ready.write(false);
+
+    uint32_t address = addr.read();
+    bool hit = true;
+    uint32_t result = 0;
+    CacheArray::Line *line = nullptr;
+    for (int i = 0; i < 4; i++)
+    {
+      uint32_t byte_addr = address + i;
+      if (i == 0 || lines.lineAddress(byte_addr) == byte_addr)
+      {
+        line = fetch(byte_addr, true, hit);
+      }
+      result |= static_cast<uint32_t>(line->data[byte_addr & (lines.lineSize() - 1)]) << (i * 8);
+    }
+    LOG_DEBUG(LOG_MEM, "Cache-%s beim Lesen: 0x%08x an Adresse 0x%08x.", hit ? "Treffer" : "Fehlzugriff", result, address);
+
+    if (hit)
+    {
+      for (uint32_t i = 0; i < HIT_LATENCY; i++)
+      {
+        wait();
+      }
+    }
+
+    rdata.write(result);
+    if (!dontSetReady)
+    {
+      ready.write(true);
+    }
+  }
+
+  void doWrite(bool count)
+  {
+    ready.write(false);
+
+    uint32_t address = addr.read();
+    uint32_t value = wdata.read();
+    uint8_t mask = be.read();
+    bool hit = true;
+    CacheArray::Line *line = nullptr;
+    for (int i = 0; i < 4; i++)
+    {
+      uint32_t byte_addr = address + i;
+      if (i == 0 || lines.lineAddress(byte_addr) == byte_addr)
+      {
+        if (write_back)
+        {
+          line = fetch(byte_addr, count, hit);
+        }
+        else
+        {
+          line = lines.find(byte_addr, count);
+          hit = hit && line != nullptr;
+        }
+      }
+      if (line != nullptr && (mask & (1u << i)))
+      {
+        line->data[byte_addr & (lines.lineSize() - 1)] = (value >> (i * 8)) & 0xFF;
+        line->dirty = write_back;
+      }
+      // Wie PagedMemory schreibt ein Wort am Ende des Adressraums nicht über 0xFFFFFFFF hinaus.
+      if (byte_addr == UINT32_MAX)
+      {
+        break;
+      }
+    }
+    LOG_DEBUG(LOG_MEM, "Cache-%s beim Schreiben: 0x%08x an Adresse 0x%08x (Byte-Enable 0x%X).", hit ? "Treffer" : "Fehlzugriff", value, address, mask & 0xF);
+
+    if (!write_back)
+    {
+      memoryWrite(address, value, mask);
+    }
+    else if (hit)
+    {
+      for (uint32_t i = 0; i < HIT_LATENCY; i++)
+      {
+        wait();
+      }
+    }
+
+    ready.write(true);
+  }
+
+  // Ab der nächsten Flanke ohne Anfrage alle geänderten Zeilen zurückschreiben; flushPending()
+  // bleibt bis zum Ende des letzten Speicherzugriffs gesetzt.
+  void requestFlush()
+  {
+    flush_pending = write_back;
+  }
+
+  bool flushPending() const
+  {
+    return flush_pending;
+  }
+
+  // Liefert die Zeile zu address und lädt sie bei einem Fehlzugriff nach. Eine verdrängte
+  // geänderte Zeile wird vorher in den Hauptspeicher zurückgeschrieben.
+  CacheArray::Line *fetch(uint32_t address, bool count, bool &hit)
+  {
+    CacheArray::Line *line = lines.find(address, count);
+    if (line != nullptr)
+    {
+      return line;
+    }
+    hit = false;
+
+    CacheArray::Line &victim = lines.victim(address);
+    if (victim.valid && victim.dirty)
+    {
+      writeBack(victim);
+      lines.writebacks += count ? 1 : 0;
+    }
+
+    uint32_t line_addr = lines.lineAddress(address);
+    LOG_TRACE(LOG_MEM, "Cache lädt Zeile 0x%08x.", line_addr);
+    for (uint32_t offset = 0; offset < lines.lineSize(); offset += 4)
+    {
+      uint32_t word = memoryRead(line_addr + offset);
+      for (int i = 0; i < 4; i++)
+      {
+        victim.data[offset + i] = (word >> (i * 8)) & 0xFF;
+      }
+    }
+    lines.install(victim, line_addr);
+    return &victim;
+  }
+
+  void writeBack(CacheArray::Line &line)
+  {
+    uint32_t line_addr = lines.addressOf(line);
+    LOG_TRACE(LOG_MEM, "Cache schreibt Zeile 0x%08x zurück.", line_addr);
+    for (uint32_t offset = 0; offset < lines.lineSize(); offset += 4)
+    {
+      const uint8_t *bytes = line.data + offset;
+      uint32_t word = static_cast<uint32_t>(bytes[0]) | static_cast<uint32_t>(bytes[1]) << 8 |
+                      static_cast<uint32_t>(bytes[2]) << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+      memoryWrite(line_addr + offset, word, 0xF);
+    }
+    line.dirty = false;
+  }
+
+  // Alle geänderten Zeilen zurückschreiben. Zählt nicht als Rückschreibung in der Statistik,
+  // die nur Verdrängungen während des Laufs erfasst.
+  void writeBackAll()
+  {
+    uint32_t count = 0;
+    for (size_t i = 0; i < lines.lineCount(); i++)
+    {
+      CacheArray::Line &line = lines.line(i);
+      if (line.valid && line.dirty)
+      {
+        writeBack(line);
+        count++;
+      }
+    }
+    LOG_DEBUG(LOG_MEM, "Cache: %u geänderte Zeilen nach der letzten Anfrage zurückgeschrieben.", count);
+  }
+
+  // Ein Wort aus dem Hauptspeicher. r wird an der ready-Flanke zurückgenommen, damit der
+  // Speicher den Zugriff nicht wiederholt; folgt direkt der nächste, bleibt r einfach gesetzt.
+  uint32_t memoryRead(uint32_t address)
+  {
+    mem_addr.write(address);
+    mem_r.write(true);
+    wait(mem_ready.posedge_event());
+    mem_r.write(false);
+    return mem_rdata.read();
+  }
+
+  void memoryWrite(uint32_t address, uint32_t value, uint8_t mask)
+  {
+    mem_addr.write(address);
+    mem_wdata.write(value);
+    mem_be.write(mask);
+    mem_w.write(true);
+    wait(mem_ready.posedge_event());
+    mem_w.write(false);
+  }
+
+private:
+  bool flush_pending = false;
+};
+
+#endif // CACHE_HPP
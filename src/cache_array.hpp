@@ -0,0 +1,212 @@
+#ifndef CACHE_ARRAY_HPP
+#define CACHE_ARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tags, Daten und Ersetzungsstrategie eines satzassoziativen Caches, ohne SystemC.
+// Größe, Zeilengröße und Assoziativität müssen Zweierpotenzen sein (Prüfung im Hauptprogramm).
+class CacheArray
+{
+public:
+    enum Replacement
+    {
+        LRU = 0,   // am längsten nicht benutzte Zeile
+        PLRU = 1,  // Baum-Pseudo-LRU mit assoc - 1 Bits je Satz
+        RANDOM = 2 // Pseudozufall mit festem Startwert, damit Läufe reproduzierbar bleiben
+    };
+
+    struct Line
+    {
+        uint32_t tag;
+        bool valid;
+        bool dirty;
+        uint8_t *data;
+    };
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    uint32_t writebacks = 0;
+
+    CacheArray(uint32_t size, uint32_t line_size, uint32_t assoc, Replacement replacement)
+        : line_size(line_size), assoc(assoc), replacement(replacement), rng_state(0x9E3779B9u)
+    {
+        num_sets = size / (line_size * assoc);
+        if (num_sets == 0)
+        {
+            num_sets = 1;
+        }
+        line_bits = log2(line_size);
+        set_bits = log2(num_sets);
+
+        storage.assign(static_cast<size_t>(num_sets) * assoc * line_size, 0);
+        lines.resize(static_cast<size_t>(num_sets) * assoc);
+        for (size_t i = 0; i < lines.size(); i++)
+        {
+            lines[i] = Line{0, false, false, &storage[i * line_size]};
+        }
+        stamps.assign(lines.size(), 0);
+        plru_bits.assign(static_cast<size_t>(num_sets) * assoc, 0);
+    }
+
+    CacheArray(const CacheArray &) = delete;
+    CacheArray &operator=(const CacheArray &) = delete;
+
+    uint32_t lineSize() const
+    {
+        return line_size;
+    }
+
+    uint32_t lineAddress(uint32_t address) const
+    {
+        return address & ~(line_size - 1);
+    }
+
+    size_t lineCount() const
+    {
+        return lines.size();
+    }
+
+    Line &line(size_t index)
+    {
+        return lines[index];
+    }
+
+    // Startadresse der Zeile, die gerade in `line` liegt
+    uint32_t addressOf(const Line &line) const
+    {
+        uint32_t set = static_cast<uint32_t>((&line - lines.data()) / assoc);
+        return (line.tag << (set_bits + line_bits)) | (set << line_bits);
+    }
+
+    // Sucht die Zeile zu address. Ein Treffer zählt als Zugriff für die Ersetzungsstrategie;
+    // ist count gesetzt, wird er außerdem als Treffer bzw. Fehlzugriff gezählt.
+    Line *find(uint32_t address, bool count = true)
+    {
+        uint32_t set = setIndex(address);
+        uint32_t tag = tagOf(address);
+        for (uint32_t way = 0; way < assoc; way++)
+        {
+            Line &line = lines[set * assoc + way];
+            if (line.valid && line.tag == tag)
+            {
+                touch(set, way);
+                hits += count ? 1 : 0;
+                return &line;
+            }
+        }
+        misses += count ? 1 : 0;
+        return nullptr;
+    }
+
+    // Wählt im Satz von address die zu ersetzende Zeile. Ungültige Zeilen werden bevorzugt.
+    Line &victim(uint32_t address)
+    {
+        uint32_t set = setIndex(address);
+        Line *base = &lines[set * assoc];
+        for (uint32_t way = 0; way < assoc; way++)
+        {
+            if (!base[way].valid)
+            {
+                return base[way];
+            }
+        }
+
+        uint32_t way = 0;
+        switch (replacement)
+        {
+        case LRU:
+            for (uint32_t i = 1; i < assoc; i++)
+            {
+                if (stamps[set * assoc + i] < stamps[set * assoc + way])
+                {
+                    way = i;
+                }
+            }
+            break;
+        case PLRU:
+        {
+            // Den Bits von der Wurzel aus folgen: 0 = links ist älter, 1 = rechts ist älter
+            const uint8_t *bits = &plru_bits[set * assoc];
+            uint32_t node = 1;
+            while (node < assoc)
+            {
+                node = 2 * node + bits[node];
+            }
+            way = node - assoc;
+            break;
+        }
+        case RANDOM:
+            rng_state ^= rng_state << 13;
+            rng_state ^= rng_state >> 17;
+            rng_state ^= rng_state << 5;
+            way = rng_state & (assoc - 1);
+            break;
+        }
+        return base[way];
+    }
+
+    // Trägt address in `line` ein; die Daten muss der Aufrufer bereits geladen haben.
+    void install(Line &line, uint32_t address)
+    {
+        uint32_t index = static_cast<uint32_t>(&line - lines.data());
+        line.tag = tagOf(address);
+        line.valid = true;
+        line.dirty = false;
+        touch(index / assoc, index % assoc);
+    }
+
+private:
+    uint32_t line_size;
+    uint32_t assoc;
+    uint32_t num_sets;
+    uint32_t line_bits;
+    uint32_t set_bits;
+    Replacement replacement;
+
+    std::vector<uint8_t> storage;
+    std::vector<Line> lines;
+    // LRU: Zeitstempel des letzten Zugriffs je Zeile
+    std::vector<uint64_t> stamps;
+    uint64_t clock = 0;
+    // PLRU: Baumknoten 1 .. assoc - 1 je Satz (Index 0 bleibt frei)
+    std::vector<uint8_t> plru_bits;
+    uint32_t rng_state;
+
+    static uint32_t log2(uint32_t value)
+    {
+        uint32_t bits = 0;
+        while ((1u << bits) < value)
+        {
+            bits++;
+        }
+        return bits;
+    }
+
+    uint32_t setIndex(uint32_t address) const
+    {
+        return (address >> line_bits) & (num_sets - 1);
+    }
+
+    uint32_t tagOf(uint32_t address) const
+    {
+        return static_cast<uint32_t>(static_cast<uint64_t>(address) >> (line_bits + set_bits));
+    }
+
+    void touch(uint32_t set, uint32_t way)
+    {
+        stamps[set * assoc + way] = ++clock;
+
+        // Auf dem Weg zur Zeile zeigt jeder Knoten danach auf die andere Hälfte
+        uint8_t *bits = &plru_bits[set * assoc];
+        uint32_t node = way + assoc;
+        while (node > 1)
+        {
+            bits[node / 2] = (node & 1) ? 0 : 1;
+            node /= 2;
+        }
+    }
+};
+
+#endif // CACHE_ARRAY_HPP
@@ -0,0 +1,63 @@
+#ifndef EDGE_TIMER_HPP
+#define EDGE_TIMER_HPP
+
+#include <systemc>
+using namespace sc_core;
+
+// Wartezeit über mehrere steigende Taktflanken für einen SC_METHOD-Zustandsautomaten, als Ersatz
+// für `for (...) wait();` in einem SC_THREAD. Statt an jeder Flanke aktiviert zu werden, wartet
+// die Methode mit einem zeitgesteuerten next_trigger() bis eine halbe Periode vor der letzten
+// Flanke und dann auf die Flanke selbst. Sie läuft damit im selben Delta-Zyklus wie ein Thread,
+// der auf clk.pos() wartet, und sieht dieselben Signalwerte.
+// Ist clk nicht mit einer sc_clock verbunden, wird die Periode nicht gekannt und jede Flanke
+// einzeln abgewartet.
+class EdgeTimer
+{
+public:
+    explicit EdgeTimer(const sc_in<bool> &clk) : clk(clk)
+    {
+    }
+
+    // Aus einer Aktivierung an einer steigenden Flanke heraus: zur `edges`-ten (>= 1) folgenden
+    // Flanke wieder aktivieren.
+    void start(uint32_t edges)
+    {
+        if (!resolved)
+        {
+            const sc_clock *clock = dynamic_cast<const sc_clock *>(clk.get_interface());
+            period = clock != nullptr ? clock->period() : SC_ZERO_TIME;
+            resolved = true;
+        }
+        if (edges > 1 && period != SC_ZERO_TIME)
+        {
+            skip = 1;
+            next_trigger(period * edges - period / 2);
+        }
+        else
+        {
+            skip = edges - 1;
+            next_trigger(clk.posedge_event());
+        }
+    }
+
+    // Zu Beginn jeder Aktivierung aufrufen. Gibt true zurück, solange die Wartezeit noch läuft;
+    // die Methode kehrt dann sofort zurück.
+    bool waiting()
+    {
+        if (skip == 0)
+        {
+            return false;
+        }
+        skip--;
+        next_trigger(clk.posedge_event());
+        return true;
+    }
+
+private:
+    const sc_in<bool> &clk;
+    sc_time period = SC_ZERO_TIME;
+    bool resolved = false;
+    uint32_t skip = 0; // noch zu übergehende Aktivierungen
+};
+
+#endif // EDGE_TIMER_HPP
@@ -0,0 +1,84 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include "latency_stats.h"
+
+static const char *class_names[REQ_CLASS_COUNT] = {
+    "rom_read", "ram_read_wide", "ram_read_narrow", "write_wide", "write_narrow", "denied"};
+
+// Größter Wert, der in Klasse `bucket` fällt
+static uint32_t bucket_upper_bound(uint32_t bucket)
+{
+    if (bucket < LAT_SUB_COUNT)
+    {
+        return bucket;
+    }
+    uint32_t shift = (bucket >> LAT_SUB_BITS) - 1;
+    uint64_t next = (uint64_t)(LAT_SUB_COUNT + (bucket & (LAT_SUB_COUNT - 1)) + 1) << shift;
+    return (uint32_t)(next - 1);
+}
+
+uint32_t latency_percentile(const struct LatencyHistogram *h, double percentile)
+{
+    if (h->count == 0)
+    {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(percentile / 100.0 * h->count + 0.5);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < LAT_BUCKETS; b++)
+    {
+        seen += h->buckets[b];
+        if (seen >= rank)
+        {
+            uint32_t bound = bucket_upper_bound(b);
+            return bound < h->max ? bound : h->max;
+        }
+    }
+    return h->max;
+}
+
+static void write_histogram(FILE *out, const char *indent, const char *name, const struct LatencyHistogram *h, bool last)
+{
+    fprintf(out, "%s\"%s\": {\"count\": %llu, \"mean\": %.3f, \"min\": %u, \"p50\": %u, \"p90\": %u, \"p99\": %u, \"max\": %u}%s\n",
+            indent, name, (unsigned long long)h->count, (double)h->sum / h->count, h->min,
+            latency_percentile(h, 50), latency_percentile(h, 90), latency_percentile(h, 99), h->max,
+            last ? "" : ",");
+}
+
+void request_stats_write_json(FILE *out, const struct RequestStats *stats)
+{
+    int last = -1;
+    fprintf(out, "{\n  \"unit\": \"cycles\",\n  \"by_class\": {\n");
+    for (int i = 0; i < REQ_CLASS_COUNT; i++)
+    {
+        last = stats->by_class[i].count > 0 ? i : last;
+    }
+    for (int i = 0; i < REQ_CLASS_COUNT; i++)
+    {
+        if (stats->by_class[i].count > 0)
+        {
+            write_histogram(out, "    ", class_names[i], &stats->by_class[i], i == last);
+        }
+    }
+
+    fprintf(out, "  },\n  \"by_user\": {\n");
+    last = -1;
+    for (int i = 0; i < 256; i++)
+    {
+        last = stats->by_user[i].count > 0 ? i : last;
+    }
+    for (int i = 0; i < 256; i++)
+    {
+        if (stats->by_user[i].count > 0)
+        {
+            char name[4];
+            snprintf(name, sizeof(name), "%d", i);
+            write_histogram(out, "    ", name, &stats->by_user[i], i == last);
+        }
+    }
+    fprintf(out, "  }\n}\n");
+}
@@ -0,0 +1,118 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Histogramm mit festen, logarithmisch-linearen Klassen wie bei HDR-Histogrammen: Werte unter
+// 2^LAT_SUB_BITS werden exakt gezählt, darüber wird jede Zweierpotenz in 2^LAT_SUB_BITS gleich
+// breite Klassen geteilt (relativer Fehler höchstens 1/16). Das Eintragen braucht keinen Speicher.
+#define LAT_SUB_BITS 4
+#define LAT_SUB_COUNT (1u << LAT_SUB_BITS)
+#define LAT_BUCKETS ((32 - LAT_SUB_BITS + 1) * LAT_SUB_COUNT)
+
+    struct LatencyHistogram
+    {
+        uint64_t count;
+        uint64_t sum;
+        uint32_t min;
+        uint32_t max;
+        uint32_t buckets[LAT_BUCKETS];
+    };
+
+    // Art einer Anfrage aus Sicht des Memory-Controllers
+    enum RequestClass
+    {
+        REQ_ROM_READ = 0,
+        REQ_RAM_READ_WIDE,
+        REQ_RAM_READ_NARROW,
+        REQ_WRITE_WIDE,
+        REQ_WRITE_NARROW,
+        REQ_DENIED, // von protection() abgewiesen
+        REQ_CLASS_COUNT
+    };
+
+    // Takte je Anfrage, nach Art und nach Benutzer aufgeschlüsselt
+    struct RequestStats
+    {
+        struct LatencyHistogram by_class[REQ_CLASS_COUNT];
+        struct LatencyHistogram by_user[256];
+    };
+
+    static inline uint32_t latency_bucket(uint32_t value)
+    {
+        if (value < LAT_SUB_COUNT)
+        {
+            return value;
+        }
+#ifdef __GNUC__
+        uint32_t msb = 31 - __builtin_clz(value);
+#else
+        uint32_t msb = 0;
+        while ((value >> msb) > 1)
+        {
+            msb++;
+        }
+#endif
+        uint32_t shift = msb - LAT_SUB_BITS;
+        return ((shift + 1) << LAT_SUB_BITS) + ((value >> shift) & (LAT_SUB_COUNT - 1));
+    }
+
+    static inline void latency_record(struct LatencyHistogram *h, uint32_t value)
+    {
+        if (h->count == 0 || value < h->min)
+        {
+            h->min = value;
+        }
+        if (value > h->max)
+        {
+            h->max = value;
+        }
+        h->count++;
+        h->sum += value;
+        h->buckets[latency_bucket(value)]++;
+    }
+
+    static inline void request_stats_record(struct RequestStats *stats, enum RequestClass cls, uint8_t user, uint32_t cycles)
+    {
+        latency_record(&stats->by_class[cls], cycles);
+        latency_record(&stats->by_user[user], cycles);
+    }
+
+    // Ordnet eine abgeschlossene Anfrage ein. rom_limit ist die tatsächliche (aufgerundete)
+    // ROM-Größe, denied gibt an, ob protection() die Anfrage abgewiesen hat.
+    static inline enum RequestClass request_class(const struct Request *req, uint32_t rom_limit, int denied)
+    {
+        if (denied)
+        {
+            return REQ_DENIED;
+        }
+        if (req->w)
+        {
+            return req->wide ? REQ_WRITE_WIDE : REQ_WRITE_NARROW;
+        }
+        if (req->addr < rom_limit)
+        {
+            return REQ_ROM_READ;
+        }
+        return req->wide ? REQ_RAM_READ_WIDE : REQ_RAM_READ_NARROW;
+    }
+
+    // Kleinster Wert, unter dem mindestens `percentile` Prozent der Einträge liegen
+    // (obere Grenze der Klasse, höchstens max)
+    uint32_t latency_percentile(const struct LatencyHistogram *h, double percentile);
+
+    // Schreibt alle nicht leeren Histogramme mit count, mean, min, p50, p90, p99 und max als JSON.
+    void request_stats_write_json(FILE *out, const struct RequestStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_STATS_H
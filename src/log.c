@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <strings.h>
+#include "log.h"
+
+uint8_t log_levels[LOG_CATEGORY_COUNT] = {LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL, LOG_DEFAULT_LEVEL};
+
+static const char *category_names[LOG_CATEGORY_COUNT] = {"MC", "MEM", "ROM", "TB"};
+static const char *level_names[] = {"off", "error", "warn", "info", "debug", "trace"};
+
+static int parse_level(const char *str, size_t len, uint8_t *level)
+{
+    for (int i = LOG_LEVEL_OFF; i <= LOG_LEVEL_TRACE; i++)
+    {
+        if (strlen(level_names[i]) == len && strncasecmp(str, level_names[i], len) == 0)
+        {
+            *level = (uint8_t)i;
+            return 0;
+        }
+    }
+    if (len == 1 && str[0] >= '0' && str[0] <= '5')
+    {
+        *level = (uint8_t)(str[0] - '0');
+        return 0;
+    }
+    return 1;
+}
+
+static int parse_category(const char *str, size_t len)
+{
+    for (int i = 0; i < LOG_CATEGORY_COUNT; i++)
+    {
+        if (strlen(category_names[i]) == len && strncasecmp(str, category_names[i], len) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int log_set_levels(const char *spec)
+{
+    uint8_t levels[LOG_CATEGORY_COUNT];
+    memcpy(levels, log_levels, sizeof(levels));
+
+    const char *item = spec;
+    while (*item != '\0')
+    {
+        const char *end = strchr(item, ',');
+        size_t len = end ? (size_t)(end - item) : strlen(item);
+        const char *eq = memchr(item, '=', len);
+        uint8_t level;
+
+        if (eq == NULL)
+        {
+            // Ohne Modulangabe gilt die Stufe für alle Module
+            if (parse_level(item, len, &level) != 0)
+            {
+                fprintf(stderr, "Ungültige Log-Stufe: %.*s\n", (int)len, item);
+                return 1;
+            }
+            for (int i = 0; i < LOG_CATEGORY_COUNT; i++)
+            {
+                levels[i] = level;
+            }
+        }
+        else
+        {
+            int category = parse_category(item, eq - item);
+            if (category < 0)
+            {
+                fprintf(stderr, "Unbekanntes Log-Modul: %.*s\n", (int)(eq - item), item);
+                return 1;
+            }
+            if (parse_level(eq + 1, len - (eq - item) - 1, &level) != 0)
+            {
+                fprintf(stderr, "Ungültige Log-Stufe: %.*s\n", (int)(len - (eq - item) - 1), eq + 1);
+                return 1;
+            }
+            levels[category] = level;
+        }
+
+        item += len;
+        if (*item == ',')
+        {
+            item++;
+        }
+    }
+
+    memcpy(log_levels, levels, sizeof(levels));
+    return 0;
+}
+
+void log_write(int category, int level, const char *format, ...)
+{
+    // Fehler und Warnungen gehen wie bisher nach stderr, alles andere nach stdout
+    FILE *out = level <= LOG_LEVEL_WARN ? stderr : stdout;
+    va_list args;
+
+    fprintf(out, "[%s] ", category_names[category]);
+    va_start(args, format);
+    vfprintf(out, format, args);
+    va_end(args);
+    fputc('\n', out);
+}
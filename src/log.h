@@ -0,0 +1,76 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Log-Stufen, aufsteigend nach Ausführlichkeit
+#define LOG_LEVEL_OFF 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_WARN
+
+// Höchste Stufe, die überhaupt einkompiliert wird. Ausgaben oberhalb dieser Stufe
+// werden vom Compiler vollständig entfernt (keine Prüfung, keine Formatierung).
+#ifndef LOG_COMPILE_LEVEL
+#ifdef NDEBUG
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_COMPILE_LEVEL LOG_LEVEL_TRACE
+#endif
+#endif
+
+    // Module, deren Ausgaben getrennt eingestellt werden können
+    enum LogCategory
+    {
+        LOG_MC = 0, // Memory-Controller
+        LOG_MEM,    // Hauptspeicher
+        LOG_ROM,    // ROM
+        LOG_TB,     // Testbench (run_simulation)
+        LOG_CATEGORY_COUNT
+    };
+
+    // Zur Laufzeit eingestellte Stufe je Modul
+    extern uint8_t log_levels[LOG_CATEGORY_COUNT];
+
+    // Liest eine Angabe wie "debug", "mc=trace,mem=info" oder "info,tb=off".
+    // Gibt 0 bei Erfolg zurück, sonst 1 (die bisherigen Einstellungen bleiben dann erhalten).
+    int log_set_levels(const char *spec);
+
+    void log_write(int category, int level, const char *format, ...)
+#ifdef __GNUC__
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+#define LOG_ENABLED(category, level) ((level) <= LOG_COMPILE_LEVEL && (level) <= log_levels[category])
+
+#define LOG_AT(category, level, ...)                     \
+    do                                                   \
+    {                                                    \
+        if (LOG_ENABLED(category, level))                \
+        {                                                \
+            log_write(category, level, __VA_ARGS__);     \
+        }                                                \
+    } while (0)
+
+#define LOG_ERROR(category, ...) LOG_AT(category, LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(category, ...) LOG_AT(category, LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(category, ...) LOG_AT(category, LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_AT(category, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define LOG_TRACE(category, ...) LOG_AT(category, LOG_LEVEL_TRACE, __VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOG_H
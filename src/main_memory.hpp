@@ -2,40 +2,55 @@
 #define MAIN_MEMORY_HPP
 
 #include <systemc>
-#include <map>
+
+#include "edge_timer.hpp"
+#include "log.h"
+#include "ram_store.hpp"
+#include "sim_profile.hpp"
+#include "memory_timing.hpp"
 using namespace sc_core;
 
 //Dieses Modul basiert größtenteils auf dem Code aus der Übungsaufgabe.
 
-SC_MODULE(MAIN_MEMORY)
+SC_MODULE(MAIN_MEMORY), public ActivityCounter
 {
   sc_in<bool> clk;
 
   sc_in<uint32_t> addr;
   sc_in<uint32_t> wdata;
+  sc_in<uint8_t> be; // Byte-Enable: Bit i schreibt das Byte an addr + i
   sc_in<bool> r;
   sc_in<bool> w;
 
   sc_out<uint32_t> rdata;
   sc_out<bool> ready{"ready_in_Mem"};
 
-  std::map<uint32_t, uint32_t> memory;
-  uint32_t latency;
+  // Seitenweise angelegter oder eingeblendeter Speicher statt einer Map mit einem Knoten pro Byte
+  RamStore memory;
+  // Feste Latenz oder DRAM-Modell mit Bänken und offenen Zeilen
+  MemoryTiming timing;
 
   SC_HAS_PROCESS(MAIN_MEMORY);
+  // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+  PROFILED_WAIT
 
-  MAIN_MEMORY(sc_module_name name, uint32_t latency_clk) : sc_module(name)
+  // dram: Parameter des DRAM-Modells, nullptr = feste Latenz latency_clk
+  // fsm: SC_METHOD-Zustandsautomat (step()) statt SC_THREAD (behaviour()), soll Takt für Takt gleich sein
+  MAIN_MEMORY(sc_module_name name, uint32_t latency_clk, const MemoryTiming::DramParams *dram = nullptr, bool fsm = false)
+      : sc_module(name), timing(dram != nullptr ? MemoryTiming(*dram) : MemoryTiming(latency_clk > 0 ? latency_clk : MEM_DEFAULT_LATENCY)),
+        timer(clk)
   {
-    if (latency_clk > 0)
+    if (fsm)
     {
-      latency = latency_clk;
+      SC_METHOD(step);
+      sensitive << clk.pos();
+      dont_initialize();
     }
     else
     {
-      latency = 3;
+      SC_THREAD(behaviour);
+      sensitive << clk.pos();
     }
-    SC_THREAD(behaviour);
-    sensitive << clk.pos();
   }
 
   void behaviour()
@@ -44,13 +59,16 @@ SC_MODULE(MAIN_MEMORY)
     {
       wait();
 
+      bool repeat = just_written;
+      just_written = false;
       if (r.read())
       {
         doRead(w.read());
+        repeat = false;
       }
       if (w.read())
       {
-        doWrite();
+        doWrite(repeat);
       }
     }
   }
@@ -60,8 +78,9 @@ SC_MODULE(MAIN_MEMORY)
     ready.write(false);
 
     uint32_t result = get(addr.read());
+    uint32_t latency = timing.access(addr.read());
 
-    for (int i = 0; i < latency; i++)
+    for (uint32_t i = 0; i < latency; i++)
     {
       wait();
     }
@@ -73,47 +92,180 @@ SC_MODULE(MAIN_MEMORY)
     }
   }
 
-  void doWrite()
+  // after_write: Flanke direkt nach dem Ende eines Schreibzugriffs (siehe repeatsWrite())
+  void doWrite(bool after_write)
   {
     ready.write(false);
-    set(addr.read(), wdata.read());
+    bool counted = !repeatsWrite(after_write);
+    set(addr.read(), wdata.read(), be.read());
+    uint32_t latency = timing.access(addr.read(), counted);
 
-    for (int i = 0; i < latency; i++)
+    for (uint32_t i = 0; i < latency; i++)
     {
       wait();
     }
 
     ready.write(true);
+    just_written = true;
   }
 
-  uint32_t get(uint32_t address)
+  // Zustandsautomat mit demselben Ablauf wie behaviour(): Lesen (mit anschließender Prüfung auf
+  // einen Schreibzugriff), dann Schreiben. Ohne anliegendes r oder w wird er erst bei einer
+  // Änderung eines der beiden wieder aktiviert.
+  void step()
   {
-    uint32_t result = 0;
-
-    for (int i = 0; i < 4; i++)
+    ActivityScope scope(*this);
+    if (timer.waiting())
     {
-      uint8_t value = 0;
-      if (memory.find(address + i) != memory.end())
+      return;
+    }
+    switch (state)
+    {
+    case MEM_IDLE:
+      // Nur bei einer Änderung zugleich mit der Flanke hätte behaviour() sie schon an dieser
+      // Flanke gesehen, sonst erst an der nächsten.
+      if (!clk.posedge())
       {
-        value = memory[address + i];
+        state = MEM_SAMPLE;
+        next_trigger(clk.posedge_event());
+        return;
       }
-      result |= value << (i * 8);
+      // fall through
+    case MEM_SAMPLE:
+      write_after_write = just_written;
+      just_written = false;
+      if (r.read())
+      {
+        write_after_write = false;
+        ready.write(false);
+        read_result = get(addr.read());
+        read_keeps_ready = w.read();
+        if (startLatency(MEM_READ))
+        {
+          return;
+        }
+        finishRead();
+      }
+      break;
+    case MEM_READ:
+      finishRead();
+      break;
+    case MEM_WRITE:
+      ready.write(true);
+      written();
+      return;
     }
-    printf("[MEM] Wert aus dem Speicher gelesen: 0x%08x an Adresse 0x%08x.\n", result, address);
+    if (w.read())
+    {
+      ready.write(false);
+      bool counted = !repeatsWrite(write_after_write);
+      set(addr.read(), wdata.read(), be.read());
+      if (startLatency(MEM_WRITE, counted))
+      {
+        return;
+      }
+      ready.write(true);
+      written();
+      return;
+    }
+    idle();
+  }
+
+  uint32_t get(uint32_t address)
+  {
+    uint32_t result = memory.readWord(address);
+    LOG_DEBUG(LOG_MEM, "Wert aus dem Speicher gelesen: 0x%08x an Adresse 0x%08x.", result, address);
     return result;
   }
 
-  void set(uint32_t address, uint32_t value)
+  void set(uint32_t address, uint32_t value, uint8_t mask)
+  {
+    memory.writeWordMasked(address, value, mask);
+    LOG_DEBUG(LOG_MEM, "Wert in den Speicher geschrieben: 0x%08x an Adresse 0x%08x (Byte-Enable 0x%X).", value, address, mask & 0xF);
+  }
+
+  uint32_t residentPages()
+  {
+    return memory.residentPages();
+  }
+
+private:
+  enum State
   {
-    for (int i = 0; i < 4; i++)
+    MEM_IDLE,   // wartet auf eine Änderung von r oder w
+    MEM_SAMPLE, // prüft r und w an der nächsten Flanke
+    MEM_READ,   // Latenz eines Lesezugriffs läuft
+    MEM_WRITE   // Latenz eines Schreibzugriffs läuft
+  };
+  State state = MEM_SAMPLE;
+  EdgeTimer timer;
+  uint32_t read_result = 0;
+  bool read_keeps_ready = false; // wie dontSetReady in doRead()
+
+  // Ein Schreibzugriff hat an der letzten Flanke geendet
+  bool just_written = false;
+  bool write_after_write = false; // wie after_write in doWrite()
+  uint32_t last_addr = 0;
+  uint32_t last_wdata = 0;
+  uint8_t last_be = 0;
+
+  // Der Controller nimmt w erst zurück, wenn er ready sieht. An der Flanke direkt nach einem
+  // Schreibzugriff liegt derselbe Zugriff deshalb noch an und wird ein zweites Mal ausgeführt.
+  // Das kostet wie bisher seine Latenz, zählt aber nicht in der DRAM-Statistik: sonst brächte
+  // jeder Schreibzugriff einen zusätzlichen Zeilentreffer mit.
+  bool repeatsWrite(bool after_write)
+  {
+    bool same = after_write && addr.read() == last_addr && wdata.read() == last_wdata && be.read() == last_be;
+    last_addr = addr.read();
+    last_wdata = wdata.read();
+    last_be = be.read();
+    return same;
+  }
+
+  // Nach einem Schreibzugriff wie behaviour() die nächste Flanke prüfen, auch wenn r und w gerade
+  // nicht anliegen: Nur dort kann die Wiederholung beginnen.
+  void written()
+  {
+    just_written = true;
+    state = MEM_SAMPLE;
+    next_trigger(clk.posedge_event());
+  }
+
+  // Latenz des Zugriffs auf addr beginnen. Gibt false zurück, wenn sie 0 ist.
+  bool startLatency(State next, bool counted = true)
+  {
+    uint32_t latency = timing.access(addr.read(), counted);
+    if (latency == 0)
     {
-      memory[address + i] = (value >> (i * 8)) & 0xFF;
-      if (address + i == UINT32_MAX)
-      {
-        break;
-      }
+      return false;
+    }
+    state = next;
+    timer.start(latency);
+    return true;
+  }
+
+  void finishRead()
+  {
+    rdata.write(read_result);
+    if (!read_keeps_ready)
+    {
+      ready.write(true);
+    }
+  }
+
+  // Entspricht dem wait() am Anfang der Schleife in behaviour()
+  void idle()
+  {
+    if (r.read() || w.read())
+    {
+      state = MEM_SAMPLE;
+      next_trigger(clk.posedge_event());
+    }
+    else
+    {
+      state = MEM_IDLE;
+      next_trigger(r.value_changed_event() | w.value_changed_event());
     }
-    printf("[MEM] Wert in den Speicher geschrieben: 0x%08x an Adresse 0x%08x.\n", value, address);
   }
 };
 
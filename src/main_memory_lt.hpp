@@ -0,0 +1,119 @@
+#ifndef MAIN_MEMORY_LT_HPP
+#define MAIN_MEMORY_LT_HPP
+
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_target_socket.h>
+#include <cstring>
+
+#include "log.h"
+#include "ram_store.hpp"
+#include "memory_timing.hpp"
+using namespace sc_core;
+
+// Loosely-timed Variante von MAIN_MEMORY: Jeder Zugriff ist ein einziger b_transport-Aufruf,
+// dessen Dauer als Verzögerung annotiert wird. Damit die Zyklenzahl mit dem signalgenauen Modell
+// übereinstimmt, bildet das Modul dessen Handshake nach:
+//  - Ein freier Speicher nimmt eine Anfrage einen Takt später an und setzt ready nach der
+//    Latenz des Zugriffs (siehe MemoryTiming).
+//  - Läuft noch ein Zugriff, wartet der Controller auf dessen ready-Flanke. Ein Lesezugriff endet
+//    dort (im Signalmodell mit veralteten Daten), ein Schreibzugriff einen Takt später.
+//  - Nach einem Schreibzugriff ist der Speicher für einen weiteren Zugriff belegt, weil das
+//    Signalmodell das noch anliegende w ein zweites Mal ausführt.
+//  - Im Byte-Enable-Modus quittiert der Controller Schreibzugriffe an der ready-Flanke; sie
+//    enden dort und werden nur einmal ausgeführt.
+// Die Daten werden dagegen immer sofort und korrekt gelesen bzw. geschrieben.
+// testcase/regression.sh vergleicht die Takte mit --mode signal.
+SC_MODULE(MAIN_MEMORY_LT)
+{
+    tlm_utils::simple_target_socket<MAIN_MEMORY_LT> socket;
+
+    RamStore memory;
+    MemoryTiming timing;
+    sc_time period;
+    bool byte_enable;
+
+    // Zeitpunkt der ready-Flanke des zuletzt begonnenen Zugriffs
+    sc_time ready_at;
+    bool accessed;
+
+    SC_HAS_PROCESS(MAIN_MEMORY_LT);
+
+    MAIN_MEMORY_LT(sc_module_name name, uint32_t latency_clk, const sc_time &period, bool byte_enable = false,
+                   const MemoryTiming::DramParams *dram = nullptr)
+        : sc_module(name), socket("socket"),
+          timing(dram != nullptr ? MemoryTiming(*dram) : MemoryTiming(latency_clk > 0 ? latency_clk : MEM_DEFAULT_LATENCY)),
+          period(period), byte_enable(byte_enable), accessed(false)
+    {
+        socket.register_b_transport(this, &MAIN_MEMORY_LT::b_transport);
+    }
+
+    void b_transport(tlm::tlm_generic_payload &trans, sc_time &delay)
+    {
+        uint32_t address = static_cast<uint32_t>(trans.get_address());
+        uint32_t value;
+        sc_time start = sc_time_stamp() + delay;
+
+        // ready-Flanke, auf die der Controller wartet
+        // Ein belegter Speicher führt den Zugriff im Signalmodell nicht mehr aus.
+        bool busy = accessed && ready_at >= start;
+        sc_time edge = busy ? ready_at : start + period * (timing.access(address) + 1);
+
+        if (trans.is_read())
+        {
+            value = get(address);
+            memcpy(trans.get_data_ptr(), &value, sizeof(value));
+            if (!busy)
+            {
+                ready_at = edge;
+            }
+            delay += edge - start;
+        }
+        else if (byte_enable)
+        {
+            uint8_t mask = 0xF;
+            if (trans.get_byte_enable_ptr() != nullptr)
+            {
+                mask = 0;
+                for (unsigned int i = 0; i < 4 && i < trans.get_byte_enable_length(); i++)
+                {
+                    mask |= trans.get_byte_enable_ptr()[i] == tlm::TLM_BYTE_ENABLED ? 1 << i : 0;
+                }
+            }
+            memcpy(&value, trans.get_data_ptr(), sizeof(value));
+            set(address, value, mask);
+            ready_at = edge;
+            delay += edge - start;
+        }
+        else
+        {
+            memcpy(&value, trans.get_data_ptr(), sizeof(value));
+            set(address, value, 0xF);
+            sc_time done = edge + period;
+            ready_at = done + period * timing.access(address);
+            delay += done - start;
+        }
+        accessed = true;
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    }
+
+    uint32_t get(uint32_t address)
+    {
+        uint32_t result = memory.readWord(address);
+        LOG_DEBUG(LOG_MEM, "Wert aus dem Speicher gelesen: 0x%08x an Adresse 0x%08x.", result, address);
+        return result;
+    }
+
+    void set(uint32_t address, uint32_t value, uint8_t mask)
+    {
+        memory.writeWordMasked(address, value, mask);
+        LOG_DEBUG(LOG_MEM, "Wert in den Speicher geschrieben: 0x%08x an Adresse 0x%08x (Byte-Enable 0x%X).", value, address, mask & 0xF);
+    }
+
+    uint32_t residentPages()
+    {
+        return memory.residentPages();
+    }
+};
+
+#endif // MAIN_MEMORY_LT_HPP
@@ -1,14 +1,17 @@
-#include <map>
 #include <systemc>
 
+#include "access_control.hpp"
+#include "log.h"
 #include "main_memory.hpp"
 #include "rom.hpp"
+#include "sim_profile.hpp"
+#include "store_buffer.hpp"
 using namespace sc_core;
 
 #ifndef MEMORY_CONTROLLER_H
 #define MEMORY_CONTROLLER_H
 
-SC_MODULE(MEMORY_CONTROLLER)
+SC_MODULE(MEMORY_CONTROLLER), public ActivityCounter
 {
 
     // input
@@ -18,6 +21,7 @@ SC_MODULE(MEMORY_CONTROLLER)
 
     // output
     sc_out<uint32_t> rdata, mem_addr, mem_wdata;
+    sc_out<uint8_t> mem_be{"memory_byte_enable"};
     sc_out<bool> ready{"ready_signal_for_CU"}, error{"error"}, mem_r{"memory_read"}, mem_w{"memory_write"};
 
     // innere Komponenten
@@ -25,24 +29,41 @@ SC_MODULE(MEMORY_CONTROLLER)
     sc_signal<uint32_t> rom_addr_sig, data_cu_rom;
     sc_signal<bool> rom_read_en, rom_wide_sig, ready_cu_rom, rom_error;
 
-    // Adresse und ihrer Benutzer
-    std::map<uint32_t, uint8_t> gewalt;
+    // Zugriffsschutz mit den Besitzern je Block oberhalb des ROMs
+    AccessControl schutz;
 
     uint32_t block_size;
     uint32_t rom_size;
+    // 1-Byte-Schreibzugriffe über mem_be statt mit vorherigem Lesezugriff
+    bool byte_enable;
+    // Schreibpuffer vor dem Hauptspeicher, ohne Einträge abgeschaltet
+    StoreBuffer store;
 
     SC_HAS_PROCESS(MEMORY_CONTROLLER);
+    // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+    PROFILED_WAIT
 
-    MEMORY_CONTROLLER(sc_module_name name, uint32_t rom_size, uint32_t *rom_content, uint32_t latency_rom, uint32_t block_size) : sc_module(name), block_size(block_size), rom_size(rom_size)
+    // fsm: Controller und ROM als SC_METHOD-Zustandsautomaten (step()) statt SC_THREADs,
+    // sollen Takt für Takt gleich sein
+    // store_entries, store_line: Schreibpuffer (siehe store_buffer.hpp), 0 Einträge = keiner
+    MEMORY_CONTROLLER(sc_module_name name, uint32_t rom_size, uint32_t *rom_content, uint32_t latency_rom, uint32_t block_size, bool byte_enable = false,
+                      uint32_t prefetch_depth = 0, bool fsm = false, uint32_t store_entries = 0,
+                      uint32_t store_line = STORE_BUFFER_DEFAULT_LINE)
+        : sc_module(name), schutz(rom_size, (rom_size + 3) & ~3u, block_size), block_size(block_size), rom_size(rom_size), byte_enable(byte_enable),
+          store(store_entries, store_line)
     {
         // initialisieren
         // die ROM-Größe soll bereits im Hauptprogramm überprüft werden
+        // Ohne ROM-Inhalt wird ein mit Nullen gefüllter Puffer angelegt, den das ROM übernimmt.
+        // Ein übergebener Inhalt wird dagegen ohne Kopie direkt verwendet.
+        bool rom_owns_content = false;
         if (rom_content == NULL)
         {
-            rom_content = new uint32_t[rom_size / sizeof(uint32_t)]();
+            rom_content = static_cast<uint32_t *>(calloc(rom_size / sizeof(uint32_t) + 1, sizeof(uint32_t)));
+            rom_owns_content = true;
         }
-        printf("ROM size is: %d Bytes.\n", rom_size);
-        rom = new ROM("rom", rom_size, rom_content, latency_rom);
+        LOG_INFO(LOG_MC, "ROM size is: %d Bytes.", rom_size);
+        rom = new ROM("rom", rom_size, rom_content, latency_rom, rom_owns_content, prefetch_depth, fsm);
         rom->read_en(rom_read_en);
         rom->clk(clk);
         rom->addr(rom_addr_sig);
@@ -51,8 +72,17 @@ SC_MODULE(MEMORY_CONTROLLER)
         rom->data(data_cu_rom);
         rom->error(rom_error);
 
-        SC_THREAD(process);
-        sensitive << clk.pos();
+        if (fsm)
+        {
+            SC_METHOD(step);
+            sensitive << clk.pos();
+            dont_initialize();
+        }
+        else
+        {
+            SC_THREAD(process);
+            sensitive << clk.pos();
+        }
     }
 
     void process()
@@ -60,7 +90,7 @@ SC_MODULE(MEMORY_CONTROLLER)
         while (true)
         {
             wait();
-            printf("MC job started~ \n");
+            LOG_TRACE(LOG_MC, "job started~");
             // ControlUnit stellt sicher, dass Lese- und Schreiboperationen nicht gleichzeitig auftreten.
             // Zur Robustheit des Programms behalten wir jedoch diese Prüfung bei.
             if (r.read() && w.read())
@@ -68,6 +98,12 @@ SC_MODULE(MEMORY_CONTROLLER)
                 SC_REPORT_ERROR("Memory Controller", "Fehler: Gleichzeitiger Lese- und Schreibzugriff ist nicht erlaubt.\n");
                 continue;
             }
+            if (!r.read() && !w.read() && !store.empty())
+            {
+                // Ohne Anfrage ein Wort aus dem Schreibpuffer in den Hauptspeicher schreiben
+                drainWord(false);
+                continue;
+            }
             if (r.read())
             {
                 ready.write(0);
@@ -108,51 +144,57 @@ SC_MODULE(MEMORY_CONTROLLER)
             // Überprüfung, ob die 4-Byte-ausgerichtete Adresse außerhalb des ROM-Bereichs liegt
             if (wide.read() && rom->size() < 4 || address > rom->size() - 4)
             {
-                printf("[MC] Fehler ohne Unterbrechung: Adresse 0x%08X beim ROM-Zugriff liegt außerhalb des gültigen Bereichs bei 4-Byte-Alignment.\n", address);
+                LOG_INFO(LOG_MC, "Fehler ohne Unterbrechung: Adresse 0x%08X beim ROM-Zugriff liegt außerhalb des gültigen Bereichs bei 4-Byte-Alignment.", address);
                 error.write(1);
                 ready.write(1);
                 return;
             }
 
-            printf("[MC] set rom_wide_sig = %d, rom_addr_sig = 0x%08X\n", wide.read(), address);
+            LOG_DEBUG(LOG_MC, "set rom_wide_sig = %d, rom_addr_sig = 0x%08X", wide.read(), address);
             rom_wide_sig.write(wide.read());
             rom_addr_sig.write(address);
             rom_read_en.write(1);
-            printf("[MC] Warten auf rom_ready.posedge_event() ...\n");
+            LOG_TRACE(LOG_MC, "Warten auf rom_ready.posedge_event() ...");
             // Warten auf Rom
             wait(ready_cu_rom.posedge_event());
 
             if (!rom_error.read())
             {
-                printf("[MC] rom_ready eingetroffen, rom_data = 0x%08X\n", data_cu_rom.read());
+                LOG_DEBUG(LOG_MC, "rom_ready eingetroffen, rom_data = 0x%08X", data_cu_rom.read());
 
                 rdata.write(data_cu_rom.read());
                 rom_read_en.write(0);
                 ready.write(1);
                 error.write(0);
-                printf("[MC] rdata set to 0x%08X, ready=1\n", data_cu_rom.read());
+                LOG_DEBUG(LOG_MC, "rdata set to 0x%08X, ready=1", data_cu_rom.read());
             }
             else
             {
-                printf("ERROR : Bei einem 4-Byte-weiten Lesezugriff ist die Adresse 0x%08x nicht 4-Byte aligned.\n", address);
+                LOG_INFO(LOG_MC, "Bei einem 4-Byte-weiten Lesezugriff ist die Adresse 0x%08x nicht 4-Byte aligned.", address);
                 rdata.write(data_cu_rom.read());
                 rom_read_en.write(0);
                 error.write(1);
                 ready.write(1);
             }
         }
-        else
+        else if (!forwardRead())
         {
+            // Gepufferte Bytes zuerst schreiben, nach jedem Speicherzugriff einen Takt Pause
+            while (readNeedsDrain())
+            {
+                drainWord(true);
+                wait();
+            }
             if (wide.read())
             {
                 uint32_t address = addr.read();
-                printf("[MC] memory 4B read request: addr=0x%08X, wide=%d\n", address, wide.read());
+                LOG_DEBUG(LOG_MC, "memory 4B read request: addr=0x%08X, wide=%d", address, wide.read());
                 mem_addr.write(addr.read());
                 mem_r.write(1);
-                printf("[MC] Warten auf mem_ready.posedge_event() ...\n");
+                LOG_TRACE(LOG_MC, "Warten auf mem_ready.posedge_event() ...");
                 wait(mem_ready.posedge_event());
                 wait(SC_ZERO_TIME);
-                printf("[MC] memory 4B read beendet: addr=0x%08X, mem_rdata=0x%08X\n", address, mem_rdata.read());
+                LOG_DEBUG(LOG_MC, "memory 4B read beendet: addr=0x%08X, mem_rdata=0x%08X", address, mem_rdata.read());
                 rdata.write(mem_rdata.read());
                 ready.write(1);
                 error.write(0);
@@ -161,17 +203,17 @@ SC_MODULE(MEMORY_CONTROLLER)
             {
                 uint32_t offset = addr.read() % 4;
                 uint32_t address = addr.read() - offset;
-                printf("[MC] memory 1B read Anfrage: addr=0x%08X, wide=%d\n", addr.read(), wide.read());
+                LOG_DEBUG(LOG_MC, "memory 1B read Anfrage: addr=0x%08X, wide=%d", addr.read(), wide.read());
                 mem_addr.write(address);
                 mem_r.write(1);
-                printf("[MC] Warten auf mem_ready.posedge_event() ...\n");
+                LOG_TRACE(LOG_MC, "Warten auf mem_ready.posedge_event() ...");
                 wait(mem_ready.posedge_event());
                 wait(SC_ZERO_TIME);
                 uint32_t raw_data = mem_rdata.read();
                 uint32_t real_data = (raw_data >> (offset * 8)) & 0xFF;
                 real_data = real_data >> (4 - offset);
                 rdata.write(real_data);
-                printf("[MC] memory 1B read beendet: addr=0x%08X, mem_rdata=0x%08X\n", addr.read(), real_data);
+                LOG_DEBUG(LOG_MC, "memory 1B read beendet: addr=0x%08X, mem_rdata=0x%08X", addr.read(), real_data);
                 ready.write(1);
                 error.write(0);
             }
@@ -179,21 +221,33 @@ SC_MODULE(MEMORY_CONTROLLER)
     }
     void write()
     {
-        if (addr.read() >= rom->size())
+        if (addr.read() >= rom->size() && store.enabled())
+        {
+            while (!storeWrite())
+            {
+                drainWord(true);
+                wait();
+            }
+        }
+        else if (addr.read() >= rom->size() && byte_enable)
+        {
+            writeWithByteEnable();
+        }
+        else if (addr.read() >= rom->size())
         {
             uint32_t new_data;
             if (!wide.read())
             {
                 // Bei 1-Byte-Alignment der Adresse muss das Datenfeld zuerst gelesen und erweitert werden.
-                printf("[MC] memory write Anfrage (1B): addr=0x%08X, wdata=0x%02X, user=%u\n", addr.read(), wdata.read() & 0xFF, user.read());
+                LOG_DEBUG(LOG_MC, "memory write Anfrage (1B): addr=0x%08X, wdata=0x%02X, user=%u", addr.read(), wdata.read() & 0xFF, user.read());
                 mem_addr.write(addr);
                 mem_r.write(1);
-                printf("[MC] Warten auf mem_ready.posedge_event() ...\n");
+                LOG_TRACE(LOG_MC, "Warten auf mem_ready.posedge_event() ...");
                 wait(mem_ready.posedge_event());
                 // Steuerung wurde noch nicht an die Control Unit zurückgegeben – Lesesignal muss zurückgesetzt werden, um Konflikte zu vermeiden.
                 mem_r.write(0);
                 uint32_t prev_data = mem_rdata.read();
-                printf("[MC] Rohdaten an Adresse 0x%08x mit Wert 0x%08x erhalten.\n", addr.read(), prev_data);
+                LOG_DEBUG(LOG_MC, "Rohdaten an Adresse 0x%08x mit Wert 0x%08x erhalten.", addr.read(), prev_data);
                 uint32_t low_8bits = wdata.read();
                 uint8_t offset = addr.read() % 4;
                 uint32_t mask = ~(0xFF << (offset * 8));
@@ -201,101 +255,540 @@ SC_MODULE(MEMORY_CONTROLLER)
                 uint32_t inserted = low_8bits << (offset * 8);
                 new_data = cleared | inserted;
 
-                printf("[MC] Neuer Datenwert: 0x%08x\n", new_data);
+                LOG_DEBUG(LOG_MC, "Neuer Datenwert: 0x%08x", new_data);
             }
             else
             {
-                printf("[MC] memory write Anfrage (4B): addr=0x%08X, wdata=0x%08X, user=%u\n", addr.read(), wdata.read(), user.read());
+                LOG_DEBUG(LOG_MC, "memory write Anfrage (4B): addr=0x%08X, wdata=0x%08X, user=%u", addr.read(), wdata.read(), user.read());
                 new_data = wdata.read();
             }
             mem_addr.write(addr);
             mem_wdata.write(new_data);
+            mem_be.write(0xF);
             mem_w.write(1);
-            printf("[MC] Warten auf mem_ready.posedge_event() ...\n");
+            LOG_TRACE(LOG_MC, "Warten auf mem_ready.posedge_event() ...");
             do
             {
                 wait();
             } while (!mem_ready.read());
             mem_w.write(0);
-            printf("[MC] memory write beendet: addr=0x%08X, wdata=0x%08X\n", addr.read(), new_data);
+            LOG_DEBUG(LOG_MC, "memory write beendet: addr=0x%08X, wdata=0x%08X", addr.read(), new_data);
             ready.write(1);
             error.write(0);
         }
         else
         {
-            printf("Die Adresse 0x%08X liegt in ROM und darf nicht verändert werden.\n", addr.read());
+            LOG_INFO(LOG_MC, "Die Adresse 0x%08X liegt in ROM und darf nicht verändert werden.", addr.read());
             error.write(1);
             ready.write(1);
             wait(SC_ZERO_TIME);
         }
     }
 
-    bool protection()
+    // Jeder Schreibzugriff ist genau ein Speicherzugriff: Bei 1 Byte wählt mem_be die Byte-Spur aus,
+    // das Wort muss also nicht vorher gelesen werden. Wie in write() bleibt mem_addr die nicht
+    // ausgerichtete Adresse, das Byte landet also wie bisher an addr + addr % 4. Der Controller
+    // nimmt w schon an der ready-Flanke zurück, damit der Hauptspeicher den Zugriff nicht ein
+    // zweites Mal ausführt.
+    void writeWithByteEnable()
     {
-        uint8_t benutzer = user.read();
-        uint32_t adresse = addr.read();
+        uint32_t address = addr.read();
+        uint32_t new_data = wdata.read();
+        uint8_t strobe = 0xF;
+        if (!wide.read())
+        {
+            uint32_t offset = address % 4;
+            new_data = (new_data & 0xFF) << (offset * 8);
+            strobe = 1 << offset;
+        }
+        LOG_DEBUG(LOG_MC, "memory write Anfrage (Byte-Enable 0x%X): addr=0x%08X, wdata=0x%08X, user=%u", strobe, address, new_data, user.read());
+        mem_addr.write(address);
+        mem_wdata.write(new_data);
+        mem_be.write(strobe);
+        mem_w.write(1);
+        LOG_TRACE(LOG_MC, "Warten auf mem_ready.posedge_event() ...");
+        wait(mem_ready.posedge_event());
+        mem_w.write(0);
+        LOG_DEBUG(LOG_MC, "memory write beendet: addr=0x%08X, wdata=0x%08X", address, new_data);
+        ready.write(1);
+        error.write(0);
+    }
 
-        if (adresse < rom->size())
+    // Zustandsautomat mit demselben Ablauf wie process(), read() und write(). Jedes wait() dort
+    // entspricht hier einem next_trigger() auf dasselbe Ereignis. Ohne anliegendes r oder w
+    // wird der Controller erst bei einer Änderung eines der beiden wieder aktiviert.
+    void step()
+    {
+        ActivityScope scope(*this);
+        switch (state)
         {
-            if (w.read())
+        case MC_IDLE:
+            // Nur bei einer Änderung zugleich mit der Flanke hätte process() sie schon an dieser
+            // Flanke gesehen, sonst erst an der nächsten.
+            if (!clk.posedge())
             {
-                printf("Fehler: Schreibzugriff auf ROM-Adresse 0x%08X ist verboten.\n", adresse);
-                return false;
+                await(MC_SAMPLE, clk.posedge_event());
+                return;
             }
-            // Jeder darf ROM lesen
-        }
-        else
-        {
-            // Berechnung der Startadresse des zugehörigen Blocks
-            uint32_t block_addr = (adresse - rom_size) / block_size;
-
-            // Der Superuser hat immer alle Berechtigungen.
-            if (benutzer == 0)
+            // fall through
+        case MC_SAMPLE:
+            LOG_TRACE(LOG_MC, "job started~");
+            if (r.read() && w.read())
             {
-                return true;
+                SC_REPORT_ERROR("Memory Controller", "Fehler: Gleichzeitiger Lese- und Schreibzugriff ist nicht erlaubt.\n");
+                break;
             }
-            else if (benutzer == 255)
+            if (!r.read() && !w.read() && !store.empty())
             {
-                gewalt.erase(block_addr);
-                return true;
+                beginDrain(false);
+                await(MC_DRAIN, mem_ready.posedge_event());
+                return;
             }
-
-            auto it = gewalt.find(block_addr);
-            if (it == gewalt.end())
+            if (r.read())
             {
-                // Dieser Block hat noch keinen Besitzer – jeder darf darauf zugreifen.
-                if (r.read())
+                ready.write(0);
+                if (!protection())
+                {
+                    error.write(1);
+                    ready.write(1);
+                    break;
+                }
+                if (addr.read() < rom->size())
                 {
-                    printf("ACHTUNG : Block 0x%08X wird noch nicht geschrieben.\n", block_addr);
-                    return true;
+                    if (beginRomRead())
+                    {
+                        await(MC_ROM_READ, ready_cu_rom.posedge_event());
+                        return;
+                    }
+                }
+                else if (!forwardRead())
+                {
+                    stepMemRead();
+                    return;
                 }
-                gewalt[block_addr] = benutzer;
-                printf("Block 0x%08X wurde User %u zugeteilt.\n", block_addr, benutzer);
-                return true;
             }
-
-            if (it->second != benutzer)
+            stepWrite();
+            return;
+        case MC_ROM_READ:
+            finishRomRead();
+            stepWrite();
+            return;
+        case MC_MEM_READ:
+            state = MC_MEM_READ_DELTA;
+            next_trigger(SC_ZERO_TIME);
+            return;
+        case MC_MEM_READ_DELTA:
+            finishMemRead();
+            stepWrite();
+            return;
+        case MC_MERGE_READ:
+            beginWordWrite(mergeByte());
+            await(MC_WORD_WRITE, clk.posedge_event());
+            return;
+        case MC_WORD_WRITE_IDLE:
+            // wie MC_IDLE, für die Abfrage von mem_ready an jeder Flanke in write()
+            if (!clk.posedge())
             {
-                printf("User %u hat keine Berechtigung auf Block 0x%08X (Adresse 0x%08X).\n", benutzer, block_addr, adresse);
-                return false;
+                await(MC_WORD_WRITE, clk.posedge_event());
+                return;
             }
+            // fall through
+        case MC_WORD_WRITE:
+            if (!mem_ready.read())
+            {
+                await(MC_WORD_WRITE_IDLE, mem_ready.value_changed_event());
+                return;
+            }
+            finishWordWrite();
+            break;
+        case MC_BYTE_ENABLE_WRITE:
+            finishByteEnableWrite();
+            break;
+        case MC_ROM_WRITE:
+            break;
+        case MC_DRAIN:
+            finishDrain();
+            break;
+        case MC_READ_DRAIN:
+            finishDrain();
+            await(MC_READ_RETRY, clk.posedge_event());
+            return;
+        case MC_READ_RETRY:
+            stepMemRead();
+            return;
+        case MC_WRITE_DRAIN:
+            finishDrain();
+            await(MC_WRITE_RETRY, clk.posedge_event());
+            return;
+        case MC_WRITE_RETRY:
+            stepStoreWrite();
+            return;
+        }
+        idle();
+    }
+
+    // Ergebnis eines 1-Byte-Lesezugriffs aus dem gelesenen Wort, wie bisher um (4 - offset) Bit
+    // verschoben. Wird auch von PIPELINED_CONTROLLER verwendet.
+    static uint32_t byteOf(uint32_t raw_data, uint32_t offset)
+    {
+        uint32_t real_data = (raw_data >> (offset * 8)) & 0xFF;
+        return real_data >> (4 - offset);
+    }
+
+    // Lesezugriff aus dem Schreibpuffer, wenn alle gelesenen Bytes dort liegen. Gibt false zurück,
+    // wenn der Hauptspeicher gelesen werden muss.
+    bool forwardRead()
+    {
+        uint32_t address = addr.read();
+        uint32_t value = 0;
+        if (!store.enabled() || !store.lookup(address, wide.read() ? 4 : 1, value))
+        {
+            return false;
         }
+        uint32_t result = wide.read() ? value : byteOf(value << (address % 4 * 8), address % 4);
+        LOG_DEBUG(LOG_MC, "Lesezugriff aus dem Schreibpuffer: addr=0x%08X, rdata=0x%08X", address, result);
+        rdata.write(result);
+        ready.write(1);
+        error.write(0);
         return true;
     }
 
-    void setRomAt(uint32_t address, uint8_t data)
+    // Liegen Bytes des Lesezugriffs noch im Schreibpuffer?
+    bool readNeedsDrain()
+    {
+        return store.overlaps(addr.read(), wide.read() ? 4 : 1);
+    }
+
+    // Schreibzugriff in den Schreibpuffer, fertig im selben Takt. Gibt false zurück, wenn der
+    // Puffer dafür erst geleert werden muss. Ein einzelnes Byte liegt wie in write() an
+    // addr + addr % 4; jenseits von 0xFFFFFFFF entfällt es wie im Hauptspeicher.
+    bool storeWrite()
     {
-        if (!rom->write(addr, data))
+        uint32_t address = addr.read();
+        uint32_t value = wide.read() ? wdata.read() : wdata.read() & 0xFF;
+        bool dropped = false;
+        if (!wide.read())
         {
-            SC_REPORT_WARNING("ROM", "Schreibzugriff auf nicht zugewiesene Adresse (Byte)");
+            dropped = address % 4 > UINT32_MAX - address;
+            address += address % 4;
         }
+        if (!dropped && !store.put(address, value, wide.read() ? 4 : 1))
+        {
+            return false;
+        }
+        LOG_DEBUG(LOG_MC, "Schreibzugriff gepuffert: addr=0x%08X, wdata=0x%08X, wide=%d, user=%u", address, value, wide.read(), user.read());
+        ready.write(1);
+        error.write(0);
+        return true;
+    }
+
+    // Ein Wort aus dem Schreibpuffer mit Byte-Enable schreiben. forced: für eine Anfrage statt im
+    // Leerlauf
+    void beginDrain(bool forced)
+    {
+        uint32_t address, value;
+        uint8_t strobe;
+        store.drainWord(address, value, strobe, forced);
+        LOG_DEBUG(LOG_MC, "Schreibpuffer leeren: addr=0x%08X, wdata=0x%08X, Byte-Enable 0x%X", address, value, strobe);
+        mem_addr.write(address);
+        mem_wdata.write(value);
+        mem_be.write(strobe);
+        mem_w.write(1);
     }
 
+    // An der ready-Flanke des Hauptspeichers; w wird wie bei finishByteEnableWrite() sofort
+    // zurückgenommen.
+    void finishDrain()
+    {
+        mem_w.write(0);
+    }
+
+    void drainWord(bool forced)
+    {
+        beginDrain(forced);
+        wait(mem_ready.posedge_event());
+        finishDrain();
+    }
+
+    bool protection()
+    {
+        return schutz.check(addr.read(), user.read(), w.read());
+    }
+
+    // Liefert 255, wenn der Block keinen Besitzer hat.
     uint8_t getOwner(uint32_t addr)
     {
-        uint32_t block_addr = (addr - rom_size) * block_size;
-        auto it = gewalt.find(block_addr);
-        return it != gewalt.end() ? it->second : 255;
+        return schutz.getOwner(addr);
+    }
+
+private:
+    enum State
+    {
+        MC_IDLE,              // wartet auf eine Änderung von r oder w
+        MC_SAMPLE,            // prüft r und w an der nächsten Flanke
+        MC_ROM_READ,          // wartet auf rom_ready
+        MC_MEM_READ,          // wartet auf mem_ready
+        MC_MEM_READ_DELTA,    // einen Delta-Zyklus nach mem_ready
+        MC_MERGE_READ,        // 1-Byte-Schreibzugriff: wartet auf das gelesene Wort
+        MC_WORD_WRITE,        // prüft mem_ready an der nächsten Flanke
+        MC_WORD_WRITE_IDLE,   // wartet auf eine Änderung von mem_ready
+        MC_BYTE_ENABLE_WRITE, // wartet auf mem_ready
+        MC_ROM_WRITE,         // einen Delta-Zyklus nach einem abgewiesenen ROM-Schreibzugriff
+        MC_DRAIN,             // Leerlauf: wartet auf mem_ready für ein Wort aus dem Schreibpuffer
+        MC_READ_DRAIN,        // Lesezugriff auf gepufferte Bytes: wartet auf mem_ready
+        MC_READ_RETRY,        // einen Takt Pause nach dem Leeren, dann weiter mit dem Lesezugriff
+        MC_WRITE_DRAIN,       // Schreibpuffer voll: wartet auf mem_ready
+        MC_WRITE_RETRY        // einen Takt Pause nach dem Leeren, dann neuer Versuch
+    };
+    State state = MC_SAMPLE;
+    // Lesezugriff auf den Hauptspeicher: Breite und Byte im Wort
+    bool read_wide = false;
+    uint32_t read_offset = 0;
+
+    void await(State next, const sc_event &event)
+    {
+        state = next;
+        next_trigger(event);
+    }
+
+    // Die folgenden Schritte setzen read() und write() für step() in einzelne Aktivierungen um.
+
+    // Beginn eines ROM-Lesezugriffs. Gibt false zurück, wenn die Adresse nicht passt; error und
+    // ready sind dann schon gesetzt.
+    bool beginRomRead()
+    {
+        uint32_t address = addr.read();
+        // Überprüfung, ob die 4-Byte-ausgerichtete Adresse außerhalb des ROM-Bereichs liegt
+        if ((wide.read() && rom->size() < 4) || address > rom->size() - 4)
+        {
+            LOG_INFO(LOG_MC, "Fehler ohne Unterbrechung: Adresse 0x%08X beim ROM-Zugriff liegt außerhalb des gültigen Bereichs bei 4-Byte-Alignment.", address);
+            error.write(1);
+            ready.write(1);
+            return false;
+        }
+
+        LOG_DEBUG(LOG_MC, "set rom_wide_sig = %d, rom_addr_sig = 0x%08X", wide.read(), address);
+        rom_wide_sig.write(wide.read());
+        rom_addr_sig.write(address);
+        rom_read_en.write(1);
+        return true;
+    }
+
+    // Nach rom_ready
+    void finishRomRead()
+    {
+        if (!rom_error.read())
+        {
+            LOG_DEBUG(LOG_MC, "rom_ready eingetroffen, rom_data = 0x%08X", data_cu_rom.read());
+
+            rdata.write(data_cu_rom.read());
+            rom_read_en.write(0);
+            ready.write(1);
+            error.write(0);
+            LOG_DEBUG(LOG_MC, "rdata set to 0x%08X, ready=1", data_cu_rom.read());
+        }
+        else
+        {
+            LOG_INFO(LOG_MC, "Bei einem 4-Byte-weiten Lesezugriff ist die Adresse 0x%08x nicht 4-Byte aligned.", rom_addr_sig.read());
+            rdata.write(data_cu_rom.read());
+            rom_read_en.write(0);
+            error.write(1);
+            ready.write(1);
+        }
+    }
+
+    // Lesezugriff auf den Hauptspeicher, 1-Byte-Zugriffe lesen das ganze Wort
+    void beginMemRead()
+    {
+        read_wide = wide.read();
+        if (read_wide)
+        {
+            LOG_DEBUG(LOG_MC, "memory 4B read request: addr=0x%08X, wide=%d", addr.read(), wide.read());
+            mem_addr.write(addr.read());
+            read_offset = 0;
+        }
+        else
+        {
+            read_offset = addr.read() % 4;
+            LOG_DEBUG(LOG_MC, "memory 1B read Anfrage: addr=0x%08X, wide=%d", addr.read(), wide.read());
+            mem_addr.write(addr.read() - read_offset);
+        }
+        mem_r.write(1);
+    }
+
+    // Einen Delta-Zyklus nach mem_ready
+    void finishMemRead()
+    {
+        if (read_wide)
+        {
+            LOG_DEBUG(LOG_MC, "memory 4B read beendet: addr=0x%08X, mem_rdata=0x%08X", addr.read(), mem_rdata.read());
+            rdata.write(mem_rdata.read());
+        }
+        else
+        {
+            uint32_t real_data = byteOf(mem_rdata.read(), read_offset);
+            rdata.write(real_data);
+            LOG_DEBUG(LOG_MC, "memory 1B read beendet: addr=0x%08X, mem_rdata=0x%08X", addr.read(), real_data);
+        }
+        ready.write(1);
+        error.write(0);
+    }
+
+    // 1-Byte-Schreibzugriff ohne Byte-Enable: zuerst das Wort lesen
+    void beginMergeRead()
+    {
+        LOG_DEBUG(LOG_MC, "memory write Anfrage (1B): addr=0x%08X, wdata=0x%02X, user=%u", addr.read(), wdata.read() & 0xFF, user.read());
+        mem_addr.write(addr.read());
+        mem_r.write(1);
+    }
+
+    // Nach mem_ready: das Byte in das gelesene Wort einsetzen
+    uint32_t mergeByte()
+    {
+        // Steuerung wurde noch nicht an die Control Unit zurückgegeben – Lesesignal muss zurückgesetzt werden, um Konflikte zu vermeiden.
+        mem_r.write(0);
+        uint32_t prev_data = mem_rdata.read();
+        LOG_DEBUG(LOG_MC, "Rohdaten an Adresse 0x%08x mit Wert 0x%08x erhalten.", addr.read(), prev_data);
+        uint32_t low_8bits = wdata.read();
+        uint8_t offset = addr.read() % 4;
+        uint32_t mask = ~(0xFF << (offset * 8));
+        uint32_t cleared = prev_data & mask;
+        uint32_t inserted = low_8bits << (offset * 8);
+        uint32_t new_data = cleared | inserted;
+
+        LOG_DEBUG(LOG_MC, "Neuer Datenwert: 0x%08x", new_data);
+        return new_data;
+    }
+
+    void beginWordWrite(uint32_t new_data)
+    {
+        mem_addr.write(addr.read());
+        mem_wdata.write(new_data);
+        mem_be.write(0xF);
+        mem_w.write(1);
+    }
+
+    // An der ersten Flanke nach beginWordWrite(), an der mem_ready anliegt
+    void finishWordWrite()
+    {
+        mem_w.write(0);
+        LOG_DEBUG(LOG_MC, "memory write beendet: addr=0x%08X, wdata=0x%08X", addr.read(), mem_wdata.read());
+        ready.write(1);
+        error.write(0);
+    }
+
+    // Wie writeWithByteEnable()
+    void beginByteEnableWrite()
+    {
+        uint32_t address = addr.read();
+        uint32_t new_data = wdata.read();
+        uint8_t strobe = 0xF;
+        if (!wide.read())
+        {
+            uint32_t offset = address % 4;
+            new_data = (new_data & 0xFF) << (offset * 8);
+            strobe = 1 << offset;
+        }
+        LOG_DEBUG(LOG_MC, "memory write Anfrage (Byte-Enable 0x%X): addr=0x%08X, wdata=0x%08X, user=%u", strobe, address, new_data, user.read());
+        mem_addr.write(address);
+        mem_wdata.write(new_data);
+        mem_be.write(strobe);
+        mem_w.write(1);
+    }
+
+    // An der ready-Flanke des Hauptspeichers
+    void finishByteEnableWrite()
+    {
+        mem_w.write(0);
+        LOG_DEBUG(LOG_MC, "memory write beendet: addr=0x%08X, wdata=0x%08X", mem_addr.read(), mem_wdata.read());
+        ready.write(1);
+        error.write(0);
+    }
+
+    // Wie nach einem Lesezugriff in process(): folgt ein Schreibzugriff?
+    void stepWrite()
+    {
+        if (!w.read())
+        {
+            idle();
+            return;
+        }
+        ready.write(0);
+        if (!protection())
+        {
+            error.write(1);
+            ready.write(1);
+            idle();
+        }
+        else if (addr.read() >= rom->size() && store.enabled())
+        {
+            stepStoreWrite();
+        }
+        else if (addr.read() >= rom->size() && byte_enable)
+        {
+            beginByteEnableWrite();
+            await(MC_BYTE_ENABLE_WRITE, mem_ready.posedge_event());
+        }
+        else if (addr.read() >= rom->size())
+        {
+            if (!wide.read())
+            {
+                beginMergeRead();
+                await(MC_MERGE_READ, mem_ready.posedge_event());
+                return;
+            }
+            LOG_DEBUG(LOG_MC, "memory write Anfrage (4B): addr=0x%08X, wdata=0x%08X, user=%u", addr.read(), wdata.read(), user.read());
+            beginWordWrite(wdata.read());
+            await(MC_WORD_WRITE, clk.posedge_event());
+        }
+        else
+        {
+            LOG_INFO(LOG_MC, "Die Adresse 0x%08X liegt in ROM und darf nicht verändert werden.", addr.read());
+            error.write(1);
+            ready.write(1);
+            state = MC_ROM_WRITE;
+            next_trigger(SC_ZERO_TIME);
+        }
+    }
+
+    // Wie die Schleife in read(): gepufferte Bytes schreiben, dann den Hauptspeicher lesen
+    void stepMemRead()
+    {
+        if (readNeedsDrain())
+        {
+            beginDrain(true);
+            await(MC_READ_DRAIN, mem_ready.posedge_event());
+            return;
+        }
+        beginMemRead();
+        await(MC_MEM_READ, mem_ready.posedge_event());
+    }
+
+    // Wie die Schleife in write()
+    void stepStoreWrite()
+    {
+        if (storeWrite())
+        {
+            idle();
+            return;
+        }
+        beginDrain(true);
+        await(MC_WRITE_DRAIN, mem_ready.posedge_event());
+    }
+
+    // Entspricht dem wait() am Anfang der Schleife in process(). Mit gefülltem Schreibpuffer wird
+    // an jeder Flanke geprüft, ob er geleert werden kann.
+    void idle()
+    {
+        if (r.read() || w.read() || !store.empty())
+        {
+            await(MC_SAMPLE, clk.posedge_event());
+        }
+        else
+        {
+            state = MC_IDLE;
+            next_trigger(r.value_changed_event() | w.value_changed_event());
+        }
     }
 };
 
@@ -0,0 +1,188 @@
+#ifndef MEMORY_CONTROLLER_LT_HPP
+#define MEMORY_CONTROLLER_LT_HPP
+
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+#include <cstring>
+
+#include "access_control.hpp"
+#include "log.h"
+#include "memory_controller.hpp"
+#include "rom_lt.hpp"
+using namespace sc_core;
+
+// Benutzer-ID einer Anfrage an den Memory-Controller
+struct UserExtension : tlm::tlm_extension<UserExtension>
+{
+    uint8_t user = 0;
+
+    tlm::tlm_extension_base *clone() const override
+    {
+        UserExtension *ext = new UserExtension;
+        ext->user = user;
+        return ext;
+    }
+
+    void copy_from(const tlm::tlm_extension_base &other) override
+    {
+        user = static_cast<const UserExtension &>(other).user;
+    }
+};
+
+// Loosely-timed Variante von MEMORY_CONTROLLER. Eine Anfrage (Datenlänge 4 = wide, 1 = ein Byte)
+// wird in einem einzigen b_transport-Aufruf bearbeitet. Die annotierte Verzögerung ist die Anzahl
+// der Takte, nach denen das Signalmodell ready setzt: die Verzögerung von ROM bzw. Hauptspeicher
+// plus ein Takt für die Rückmeldung. Abgewiesene Anfragen dauern einen Takt.
+SC_MODULE(MEMORY_CONTROLLER_LT)
+{
+    tlm_utils::simple_target_socket<MEMORY_CONTROLLER_LT> socket;
+    tlm_utils::simple_initiator_socket<MEMORY_CONTROLLER_LT> mem_socket;
+
+    // innere Komponenten
+    ROM_LT *rom;
+    tlm_utils::simple_initiator_socket<MEMORY_CONTROLLER_LT> rom_socket;
+
+    // Zugriffsschutz mit den Besitzern je Block oberhalb des ROMs
+    AccessControl schutz;
+
+    sc_time period;
+    // 1-Byte-Schreibzugriffe mit Byte-Enable statt mit vorherigem Lesezugriff
+    bool byte_enable;
+
+    SC_HAS_PROCESS(MEMORY_CONTROLLER_LT);
+
+    MEMORY_CONTROLLER_LT(sc_module_name name, uint32_t rom_size, uint32_t *rom_content, uint32_t latency_rom, uint32_t block_size, const sc_time &period, bool byte_enable = false,
+                         uint32_t prefetch_depth = 0)
+        : sc_module(name), socket("socket"), mem_socket("mem_socket"), rom_socket("rom_socket"),
+          schutz(rom_size, (rom_size + 3) & ~3u, block_size), period(period), byte_enable(byte_enable)
+    {
+        // Ohne ROM-Inhalt wird wie im Signalmodell ein mit Nullen gefüllter Puffer angelegt.
+        bool rom_owns_content = false;
+        if (rom_content == NULL)
+        {
+            rom_content = static_cast<uint32_t *>(calloc(rom_size / sizeof(uint32_t) + 1, sizeof(uint32_t)));
+            rom_owns_content = true;
+        }
+        LOG_INFO(LOG_MC, "ROM size is: %d Bytes.", rom_size);
+        rom = new ROM_LT("rom", rom_size, rom_content, latency_rom, period, rom_owns_content, prefetch_depth);
+        rom_socket.bind(rom->socket);
+
+        socket.register_b_transport(this, &MEMORY_CONTROLLER_LT::b_transport);
+    }
+
+    void b_transport(tlm::tlm_generic_payload &trans, sc_time &delay)
+    {
+        uint32_t address = static_cast<uint32_t>(trans.get_address());
+        bool wide = trans.get_data_length() == 4;
+        UserExtension *ext;
+        trans.get_extension(ext);
+        uint8_t user = ext != nullptr ? ext->user : 0;
+
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+        if (!schutz.check(address, user, trans.is_write()))
+        {
+            trans.set_response_status(tlm::TLM_GENERIC_ERROR_RESPONSE);
+        }
+        else if (address < rom->size())
+        {
+            // Überprüfung, ob die 4-Byte-ausgerichtete Adresse außerhalb des ROM-Bereichs liegt
+            if ((wide && rom->size() < 4) || address > rom->size() - 4)
+            {
+                LOG_INFO(LOG_MC, "Fehler ohne Unterbrechung: Adresse 0x%08X beim ROM-Zugriff liegt außerhalb des gültigen Bereichs bei 4-Byte-Alignment.", address);
+                trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+            }
+            else
+            {
+                rom_socket->b_transport(trans, delay);
+                if (trans.is_response_error())
+                {
+                    LOG_INFO(LOG_MC, "Bei einem 4-Byte-weiten Lesezugriff ist die Adresse 0x%08x nicht 4-Byte aligned.", address);
+                }
+            }
+        }
+        else if (trans.is_read())
+        {
+            readMemory(trans, address, wide, delay);
+        }
+        else
+        {
+            writeMemory(trans, address, wide, delay);
+        }
+
+        // Takt, in dem der Controller ready setzt
+        delay += period;
+    }
+
+    void readMemory(tlm::tlm_generic_payload &trans, uint32_t address, bool wide, sc_time &delay)
+    {
+        uint32_t offset = wide ? 0 : address % 4;
+        uint32_t word = memoryAccess(tlm::TLM_READ_COMMAND, address - offset, 0, delay);
+        if (wide)
+        {
+            memcpy(trans.get_data_ptr(), &word, sizeof(word));
+            LOG_DEBUG(LOG_MC, "memory 4B read beendet: addr=0x%08X, mem_rdata=0x%08X", address, word);
+        }
+        else
+        {
+            // Dieselben Daten wie im Signalmodell
+            *trans.get_data_ptr() = static_cast<uint8_t>(MEMORY_CONTROLLER::byteOf(word, offset));
+            LOG_DEBUG(LOG_MC, "memory 1B read beendet: addr=0x%08X, mem_rdata=0x%02X", address, *trans.get_data_ptr());
+        }
+    }
+
+    void writeMemory(tlm::tlm_generic_payload &trans, uint32_t address, bool wide, sc_time &delay)
+    {
+        uint32_t new_data;
+        if (wide)
+        {
+            memcpy(&new_data, trans.get_data_ptr(), sizeof(new_data));
+            memoryAccess(tlm::TLM_WRITE_COMMAND, address, new_data, delay);
+        }
+        else if (byte_enable)
+        {
+            uint32_t offset = address % 4;
+            uint8_t lanes[4] = {tlm::TLM_BYTE_DISABLED, tlm::TLM_BYTE_DISABLED, tlm::TLM_BYTE_DISABLED, tlm::TLM_BYTE_DISABLED};
+            lanes[offset] = tlm::TLM_BYTE_ENABLED;
+            new_data = static_cast<uint32_t>(*trans.get_data_ptr()) << (offset * 8);
+            memoryAccess(tlm::TLM_WRITE_COMMAND, address, new_data, delay, lanes);
+        }
+        else
+        {
+            // Wie im Signalmodell wird das Wort an der nicht ausgerichteten Adresse gelesen, das Byte
+            // in die Spur address % 4 eingesetzt und das Wort an dieselbe Adresse geschrieben.
+            uint32_t offset = address % 4;
+            uint32_t prev_data = memoryAccess(tlm::TLM_READ_COMMAND, address, 0, delay);
+            new_data = (prev_data & ~(0xFFu << (offset * 8))) | (static_cast<uint32_t>(*trans.get_data_ptr()) << (offset * 8));
+            memoryAccess(tlm::TLM_WRITE_COMMAND, address, new_data, delay);
+        }
+        LOG_DEBUG(LOG_MC, "memory write beendet: addr=0x%08X, wdata=0x%08X", address, new_data);
+    }
+
+    uint32_t memoryAccess(tlm::tlm_command command, uint32_t address, uint32_t value, sc_time &delay, uint8_t *byte_enable_lanes = nullptr)
+    {
+        mem_trans.set_command(command);
+        mem_trans.set_address(address);
+        mem_trans.set_data_ptr(reinterpret_cast<unsigned char *>(&value));
+        mem_trans.set_data_length(sizeof(value));
+        mem_trans.set_streaming_width(sizeof(value));
+        mem_trans.set_byte_enable_ptr(byte_enable_lanes);
+        mem_trans.set_byte_enable_length(byte_enable_lanes != nullptr ? sizeof(value) : 0);
+        mem_trans.set_dmi_allowed(false);
+        mem_trans.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+        mem_socket->b_transport(mem_trans, delay);
+        return value;
+    }
+
+    // Liefert 255, wenn der Block keinen Besitzer hat.
+    uint8_t getOwner(uint32_t addr)
+    {
+        return schutz.getOwner(addr);
+    }
+
+private:
+    tlm::tlm_generic_payload mem_trans;
+};
+
+#endif // MEMORY_CONTROLLER_LT_HPP
@@ -0,0 +1,96 @@
+#ifndef MEMORY_TIMING_HPP
+#define MEMORY_TIMING_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "rahmenprogramm.h"
+
+// Latenz eines Hauptspeicherzugriffs in Takten. Ohne DRAM-Modell ist sie immer gleich.
+// Im DRAM-Modell hat jede Bank eine offene Zeile (Open-Page-Strategie):
+//  - Zeilentreffer:  tCAS
+//  - Bank ohne offene Zeile: tRCD + tCAS
+//  - Zeilenkonflikt: tRP + tRCD + tCAS
+// Die Adresse wird als Zeile | Bank | Spalte aufgeteilt, aufeinanderfolgende Zeilen liegen also
+// in verschiedenen Bänken. Wird vom signalgenauen und vom LT-Modell verwendet.
+class MemoryTiming
+{
+public:
+  struct DramParams
+  {
+    uint32_t banks;
+    uint32_t row_size; // Bytes je Zeile und Bank
+    uint32_t t_rcd;    // Zeile öffnen (Activate bis Lesen/Schreiben)
+    uint32_t t_cas;    // Spaltenzugriff
+    uint32_t t_rp;     // Zeile schließen (Precharge)
+  };
+
+  uint64_t row_hits = 0;
+  uint64_t row_misses = 0; // Bank hatte keine offene Zeile
+  uint64_t row_conflicts = 0;
+
+  explicit MemoryTiming(uint32_t latency) : latency(latency), dram(false), params{}
+  {
+  }
+
+  explicit MemoryTiming(const DramParams &params)
+      : latency(0), dram(true), params(params), open_row(params.banks, NO_ROW)
+  {
+  }
+
+  // DRAM-Parameter aus den Simulationsoptionen, 0 steht jeweils für den Standardwert
+  static DramParams paramsFrom(const struct SimOptions &opts)
+  {
+    return DramParams{opts.dram_banks > 0 ? opts.dram_banks : DRAM_DEFAULT_BANKS,
+                      opts.dram_row_size > 0 ? opts.dram_row_size : DRAM_DEFAULT_ROW_SIZE,
+                      opts.dram_t_rcd > 0 ? opts.dram_t_rcd : DRAM_DEFAULT_T_RCD,
+                      opts.dram_t_cas > 0 ? opts.dram_t_cas : DRAM_DEFAULT_T_CAS,
+                      opts.dram_t_rp > 0 ? opts.dram_t_rp : DRAM_DEFAULT_T_RP};
+  }
+
+  bool isDram() const
+  {
+    return dram;
+  }
+
+  // Latenz des Zugriffs auf `address`; im DRAM-Modell wird dabei die Zeile geöffnet.
+  // counted = false: Wiederholung eines Zugriffs, der die Zähler nicht erhöht.
+  uint32_t access(uint32_t address, bool counted = true)
+  {
+    if (!dram)
+    {
+      return latency;
+    }
+    uint32_t chunk = address / params.row_size;
+    uint32_t bank = chunk % params.banks;
+    uint32_t row = chunk / params.banks;
+
+    if (open_row[bank] == row)
+    {
+      row_hits += counted;
+      return params.t_cas;
+    }
+    uint32_t cycles = params.t_rcd + params.t_cas;
+    if (open_row[bank] == NO_ROW)
+    {
+      row_misses += counted;
+    }
+    else
+    {
+      row_conflicts += counted;
+      cycles += params.t_rp;
+    }
+    open_row[bank] = row;
+    return cycles;
+  }
+
+private:
+  static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+  uint32_t latency;
+  bool dram;
+  DramParams params;
+  std::vector<uint32_t> open_row;
+};
+
+#endif // MEMORY_TIMING_HPP
@@ -0,0 +1,277 @@
+#ifndef MULTI_MASTER_HPP
+#define MULTI_MASTER_HPP
+
+#include <systemc>
+#include <vector>
+
+#include "access_control.hpp"
+#include "latency_stats.h"
+#include "log.h"
+#include "rahmenprogramm.h"
+#include "sim_profile.hpp"
+using namespace sc_core;
+
+// Vorderstufe für mehrere Master: Die Anfragen werden nach Benutzer auf gleichzeitig laufende
+// Ströme verteilt (ein Master je Benutzer, aufsteigend nach Benutzer-ID). Jeder Master stellt pro
+// Takt höchstens eine Anfrage in seine Warteschlange der Tiefe queue_depth. Ist der
+// Memory-Controller frei, wählt der Arbiter eine Warteschlange aus:
+//  - ARBITRATION_ROUND_ROBIN: reihum ab dem zuletzt bedienten Master
+//  - ARBITRATION_PRIORITY: immer der Master mit der kleinsten Benutzer-ID
+//  - ARBITRATION_WEIGHTED: gewichtetes Round-Robin (glatt, wie bei nginx) nach SimOptions.master_weight
+// Der Handshake zum Controller entspricht dem der Testbench in run_simulation_ext.
+SC_MODULE(MULTI_MASTER), public ActivityCounter
+{
+    sc_in<bool> clk;
+
+    // zum Memory-Controller
+    sc_out<uint32_t> addr, wdata;
+    sc_out<bool> r, w, wide;
+    sc_out<uint8_t> user;
+    sc_in<bool> ready, error;
+
+    bool finished;
+    uint32_t finish_cycle; // Takte bis einschließlich der Antwort auf die letzte Anfrage
+    uint32_t error_count;
+
+    SC_HAS_PROCESS(MULTI_MASTER);
+    // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+    PROFILED_WAIT
+
+    // schutz/rom_limit: zur Einordnung für stats (siehe latency_stats.h); stats und master_stats
+    // (256 Einträge, Index = Benutzer-ID) dürfen NULL sein.
+    MULTI_MASTER(sc_module_name name, const struct Request *requests, uint32_t num_requests, const struct SimOptions &opts,
+                 AccessControl *schutz, uint32_t rom_limit)
+        : sc_module(name), finished(false), finish_cycle(0), error_count(0), requests(requests),
+          queue_depth(opts.master_queue > 0 ? opts.master_queue : MASTER_DEFAULT_QUEUE), policy(opts.arbitration),
+          schutz(schutz), rom_limit(rom_limit), stats(opts.stats), master_stats(opts.master_stats)
+    {
+        // Ströme aufteilen: ein Indexfeld, nach Master gruppiert, in Trace-Reihenfolge
+        uint32_t count[256] = {0};
+        for (uint32_t i = 0; i < num_requests; i++)
+        {
+            count[requests[i].user]++;
+        }
+        uint32_t offset = 0;
+        uint32_t start[256];
+        for (int u = 0; u < 256; u++)
+        {
+            start[u] = offset;
+            if (count[u] > 0)
+            {
+                Master m;
+                m.user = static_cast<uint8_t>(u);
+                m.next = offset;
+                m.end = offset + count[u];
+                m.weight = opts.master_weight[u] > 0 ? opts.master_weight[u] : 1;
+                m.queue.resize(queue_depth);
+                masters.push_back(m);
+            }
+            offset += count[u];
+        }
+        order.resize(num_requests);
+        for (uint32_t i = 0; i < num_requests; i++)
+        {
+            order[start[requests[i].user]++] = i;
+        }
+        LOG_INFO(LOG_TB, "%zu Master, Warteschlangen mit je %u Plätzen", masters.size(), queue_depth);
+
+        SC_METHOD(tick);
+        sensitive << clk.pos();
+        dont_initialize();
+        SC_THREAD(run);
+    }
+
+private:
+    struct Slot
+    {
+        uint32_t index;       // in requests
+        uint32_t enqueued_at; // Takt
+    };
+
+    struct Master
+    {
+        uint8_t user;
+        uint32_t next; // nächster Eintrag in order, der noch nicht in der Warteschlange ist
+        uint32_t end;
+        uint32_t weight;
+        int64_t credit = 0; // für ARBITRATION_WEIGHTED
+        std::vector<Slot> queue;
+        uint32_t head = 0;
+        uint32_t size = 0;
+    };
+
+    const struct Request *requests;
+    uint32_t queue_depth;
+    uint8_t policy;
+    AccessControl *schutz;
+    uint32_t rom_limit;
+    struct RequestStats *stats;
+    struct MasterStats *master_stats;
+
+    std::vector<uint32_t> order;
+    std::vector<Master> masters;
+    size_t last_granted = SIZE_MAX;
+    uint32_t cycle = 0; // aktueller Takt, ab der Flanke zu seinem Beginn
+    uint32_t edges = 0; // gezählte Flanken
+
+    // Jeder Master stellt höchstens eine Anfrage pro Takt ein, die erste schon vor Takt 0.
+    void enqueue()
+    {
+        for (Master &m : masters)
+        {
+            if (m.next < m.end && m.size < queue_depth)
+            {
+                m.queue[(m.head + m.size) % queue_depth] = Slot{order[m.next++], cycle};
+                m.size++;
+            }
+        }
+    }
+
+    int pick()
+    {
+        size_t n = masters.size();
+        if (policy == ARBITRATION_PRIORITY)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                if (masters[i].size > 0)
+                    return static_cast<int>(i);
+            }
+            return -1;
+        }
+        if (policy == ARBITRATION_WEIGHTED)
+        {
+            int best = -1;
+            int64_t total = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                if (masters[i].size == 0)
+                    continue;
+                masters[i].credit += masters[i].weight;
+                total += masters[i].weight;
+                if (best < 0 || masters[i].credit > masters[best].credit)
+                    best = static_cast<int>(i);
+            }
+            if (best >= 0)
+                masters[best].credit -= total;
+            return best;
+        }
+        for (size_t k = 1; k <= n; k++)
+        {
+            size_t i = (last_granted + k) % n;
+            if (masters[i].size > 0)
+            {
+                last_granted = i;
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    // Zählt die Takte und reiht an jeder Flanke ein (siehe enqueue()).
+    void tick()
+    {
+        ActivityScope scope(*this);
+        cycle = edges++;
+        enqueue();
+    }
+
+    bool pending() const
+    {
+        for (const Master &m : masters)
+        {
+            if (m.next < m.end)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Der Controller übernimmt eine Anfrage an der ersten Flanke nach dem Takt, in dem er ready für
+    // die vorige gesetzt hat, und hält r und w nicht selbst zurück. Wie die Testbench in
+    // run_simulation_ext legt der Master die nächste Anfrage deshalb noch im selben Takt an, sobald
+    // ready steigt; an der Flanke sähe der Controller sonst die alte Anfrage und führte sie erneut
+    // aus. Eine Anfrage dauert so wie dort vom Takt der Übernahme bis einschließlich des Takts mit
+    // der ready-Flanke.
+    void run()
+    {
+        // Vor der ersten Flanke, damit der Controller die erste Anfrage in Takt 0 übernimmt
+        enqueue();
+
+        while (true)
+        {
+            int next = pick();
+            if (next < 0)
+            {
+                r.write(false);
+                w.write(false);
+                if (!pending())
+                {
+                    finished = true;
+                    sc_pause();
+                    return;
+                }
+                // Erst an der nächsten Flanke wird wieder eingereiht.
+                wait(clk.posedge_event());
+                wait(SC_ZERO_TIME);
+                continue;
+            }
+
+            Master &current = masters[next];
+            Slot slot = current.queue[current.head];
+            current.head = (current.head + 1) % queue_depth;
+            current.size--;
+
+            const Request &req = requests[slot.index];
+            addr.write(req.addr);
+            wdata.write(req.data);
+            w.write(req.w);
+            r.write(!req.w);
+            wide.write(req.wide);
+            user.write(req.user);
+            uint64_t rejected_before = schutz->rejected;
+
+            // An dieser Flanke übernimmt der Controller die Anfrage und setzt ready zurück, außer er
+            // beantwortet sie sofort (abgewiesen oder aus dem Schreibpuffer). Sein Wert ist erst im
+            // nächsten Delta-Zyklus sichtbar; dann hat auch tick() den Takt gezählt.
+            wait(clk.posedge_event());
+            wait(SC_ZERO_TIME);
+            uint32_t granted_at = cycle;
+            LOG_DEBUG(LOG_TB, "[%s] Master %u: %s request: addr=0x%x, data=0x%x, wide=%d (%u Takte gewartet)",
+                      sc_time_stamp().to_string().c_str(), (unsigned)req.user, req.w ? "WRITE" : "READ",
+                      req.addr, req.data, (int)req.wide, granted_at - slot.enqueued_at);
+            if (!ready.read())
+            {
+                wait(ready.posedge_event());
+            }
+
+            bool failed = error.read();
+            if (failed)
+            {
+                LOG_INFO(LOG_TB, " --> FEHLER: Modul hat einen Fehler bei der Anfrage gemeldet %u", slot.index);
+                error_count++;
+            }
+            uint32_t service = cycle - granted_at + 1;
+            if (stats != nullptr)
+            {
+                request_stats_record(stats, request_class(&req, rom_limit, schutz->rejected != rejected_before),
+                                     req.user, service);
+            }
+            finish_cycle = cycle + 1;
+            if (master_stats != nullptr)
+            {
+                struct MasterStats &ms = master_stats[current.user];
+                uint32_t queued = granted_at - slot.enqueued_at;
+                ms.requests++;
+                ms.errors += failed ? 1 : 0;
+                ms.queue_cycles += queued;
+                ms.max_queue_cycles = queued > ms.max_queue_cycles ? queued : ms.max_queue_cycles;
+                ms.service_cycles += service;
+                ms.finish_cycle = finish_cycle;
+            }
+        }
+    }
+};
+
+#endif // MULTI_MASTER_HPP
@@ -0,0 +1,171 @@
+#ifndef PAGED_MEMORY_HPP
+#define PAGED_MEMORY_HPP
+
+#include <cstdint>
+#include <cstring>
+
+// Dünn besetzter Byte-Speicher für den gesamten 32-Bit-Adressraum.
+// Seiten zu 4 KiB werden erst beim ersten Schreibzugriff angelegt und über eine
+// zweistufige Seitentabelle (10 Bit Verzeichnis, 10 Bit Tabelle, 12 Bit Offset) gefunden.
+// Nie beschriebene Bytes lesen sich als 0.
+class PagedMemory
+{
+public:
+    static const uint32_t PAGE_BITS = 12;
+    static const uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static const uint32_t TABLE_BITS = 10;
+    static const uint32_t TABLE_SIZE = 1u << TABLE_BITS;
+
+    PagedMemory() : resident_pages(0)
+    {
+        memset(directory, 0, sizeof(directory));
+    }
+
+    ~PagedMemory()
+    {
+        for (uint32_t d = 0; d < TABLE_SIZE; d++)
+        {
+            if (directory[d] == nullptr)
+            {
+                continue;
+            }
+            for (uint32_t t = 0; t < TABLE_SIZE; t++)
+            {
+                delete[] directory[d][t];
+            }
+            delete[] directory[d];
+        }
+    }
+
+    PagedMemory(const PagedMemory &) = delete;
+    PagedMemory &operator=(const PagedMemory &) = delete;
+
+    // 4-Byte-Lesezugriff (Little Endian). Liegt das Wort vollständig in einer Seite,
+    // genügt ein einziger Tabellenzugriff; sonst wird byteweise gelesen und die Adresse
+    // läuft wie bisher über 0xFFFFFFFF hinaus auf 0 um.
+    uint32_t readWord(uint32_t address) const
+    {
+        uint32_t offset = address & (PAGE_SIZE - 1);
+        if (offset <= PAGE_SIZE - 4)
+        {
+            const uint8_t *page = findPage(address);
+            if (page == nullptr)
+            {
+                return 0;
+            }
+            return static_cast<uint32_t>(page[offset]) |
+                   static_cast<uint32_t>(page[offset + 1]) << 8 |
+                   static_cast<uint32_t>(page[offset + 2]) << 16 |
+                   static_cast<uint32_t>(page[offset + 3]) << 24;
+        }
+
+        uint32_t result = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            result |= static_cast<uint32_t>(readByte(address + i)) << (i * 8);
+        }
+        return result;
+    }
+
+    // 4-Byte-Schreibzugriff (Little Endian). Am Ende des Adressraums werden nur die
+    // Bytes bis einschließlich 0xFFFFFFFF geschrieben.
+    void writeWord(uint32_t address, uint32_t value)
+    {
+        uint32_t offset = address & (PAGE_SIZE - 1);
+        if (offset <= PAGE_SIZE - 4)
+        {
+            uint8_t *page = touchPage(address);
+            page[offset] = value & 0xFF;
+            page[offset + 1] = (value >> 8) & 0xFF;
+            page[offset + 2] = (value >> 16) & 0xFF;
+            page[offset + 3] = (value >> 24) & 0xFF;
+            return;
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            writeByte(address + i, (value >> (i * 8)) & 0xFF);
+            if (address + i == UINT32_MAX)
+            {
+                break;
+            }
+        }
+    }
+
+    // Schreibt nur die Bytes, deren Bit in mask gesetzt ist (Bit i gehört zu address + i).
+    void writeWordMasked(uint32_t address, uint32_t value, uint8_t mask)
+    {
+        if ((mask & 0xF) == 0xF)
+        {
+            writeWord(address, value);
+            return;
+        }
+        for (int i = 0; i < 4; i++)
+        {
+            if (mask & (1u << i))
+            {
+                writeByte(address + i, (value >> (i * 8)) & 0xFF);
+            }
+        }
+    }
+
+    uint8_t readByte(uint32_t address) const
+    {
+        const uint8_t *page = findPage(address);
+        return page != nullptr ? page[address & (PAGE_SIZE - 1)] : 0;
+    }
+
+    void writeByte(uint32_t address, uint8_t value)
+    {
+        touchPage(address)[address & (PAGE_SIZE - 1)] = value;
+    }
+
+    // Anzahl der bisher angelegten Seiten
+    uint32_t residentPages() const
+    {
+        return resident_pages;
+    }
+
+    uint64_t residentBytes() const
+    {
+        return static_cast<uint64_t>(resident_pages) * PAGE_SIZE;
+    }
+
+private:
+    uint8_t **directory[TABLE_SIZE];
+    uint32_t resident_pages;
+
+    static uint32_t dirIndex(uint32_t address)
+    {
+        return address >> (PAGE_BITS + TABLE_BITS);
+    }
+
+    static uint32_t tableIndex(uint32_t address)
+    {
+        return (address >> PAGE_BITS) & (TABLE_SIZE - 1);
+    }
+
+    const uint8_t *findPage(uint32_t address) const
+    {
+        uint8_t **table = directory[dirIndex(address)];
+        return table != nullptr ? table[tableIndex(address)] : nullptr;
+    }
+
+    uint8_t *touchPage(uint32_t address)
+    {
+        uint8_t **&table = directory[dirIndex(address)];
+        if (table == nullptr)
+        {
+            table = new uint8_t *[TABLE_SIZE]();
+        }
+        uint8_t *&page = table[tableIndex(address)];
+        if (page == nullptr)
+        {
+            page = new uint8_t[PAGE_SIZE]();
+            resident_pages++;
+        }
+        return page;
+    }
+};
+
+#endif // PAGED_MEMORY_HPP
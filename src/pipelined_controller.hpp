@@ -0,0 +1,250 @@
+#ifndef PIPELINED_CONTROLLER_HPP
+#define PIPELINED_CONTROLLER_HPP
+
+#include <systemc>
+#include <cstdlib>
+#include <vector>
+
+#include "access_control.hpp"
+#include "log.h"
+#include "memory_controller.hpp"
+#include "rom_image.hpp"
+#include "rom_prefetcher.hpp"
+#include "sim_profile.hpp"
+using namespace sc_core;
+
+// Nicht blockierender Memory-Controller für den Split-Transaction-Modus (--mode pipelined).
+// Eine Anfrage wird an einer Flanke übernommen, an der req_valid und req_ready anliegen; danach
+// kann sofort die nächste folgen, solange weniger als `outstanding` Anfragen offen sind. Jede
+// Antwort trägt den Tag ihrer Anfrage. Mit in_order kommen die Antworten in der Reihenfolge der
+// Anfragen, sonst sobald sie fertig sind.
+//
+// Zugriffsschutz und ROM-Prüfungen entsprechen MEMORY_CONTROLLER. Der ROM antwortet nach
+// latency_rom Takten (mit Prefetcher bei einem Treffer nach einem), Hauptspeicherzugriffe laufen über PIPELINED_MEMORY (Tag = Platz im
+// Controller). 1-Byte-Schreibzugriffe verwenden immer Byte-Enable statt Read-Modify-Write,
+// damit kein Zugriff auf einen anderen warten muss. 1-Byte-Lesezugriffe auf den Hauptspeicher
+// liefern wie im signalgenauen Modell MEMORY_CONTROLLER::byteOf(), damit beide Modi für dieselbe
+// Anfragedatei dieselben Daten zurückgeben.
+SC_MODULE(PIPELINED_CONTROLLER), public ActivityCounter
+{
+    sc_in<bool> clk;
+
+    // Anfragen
+    sc_in<bool> req_valid, req_w, req_wide;
+    sc_in<uint32_t> req_addr, req_wdata;
+    sc_in<uint8_t> req_user, req_tag;
+    sc_out<bool> req_ready;
+
+    // Antworten
+    sc_out<bool> resp_valid, resp_error;
+    sc_out<uint8_t> resp_tag;
+    sc_out<uint32_t> resp_rdata;
+
+    // zum Hauptspeicher
+    sc_out<bool> mem_valid, mem_write;
+    sc_out<uint8_t> mem_tag, mem_be;
+    sc_out<uint32_t> mem_addr, mem_wdata;
+    sc_in<bool> mem_resp_valid;
+    sc_in<uint8_t> mem_resp_tag;
+    sc_in<uint32_t> mem_resp_rdata;
+
+    AccessControl schutz;
+    RomImage rom;
+    // Zeilenpuffer vor dem ROM, liefert ohne Prefetcher immer latency_rom
+    RomPrefetcher prefetch;
+
+    // Je Anfrage-Tag: von protection() abgewiesen (für die Einordnung in latency_stats.h)
+    bool denied[256] = {};
+    // Höchstzahl gleichzeitig offener Anfragen
+    uint32_t max_outstanding = 0;
+
+    SC_HAS_PROCESS(PIPELINED_CONTROLLER);
+    // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+    PROFILED_WAIT
+
+    PIPELINED_CONTROLLER(sc_module_name name, uint32_t rom_size, uint32_t *rom_content, uint32_t latency_rom,
+                         uint32_t block_size, uint32_t outstanding, bool in_order, uint32_t prefetch_depth = 0)
+        : sc_module(name), schutz(rom_size, (rom_size + 3) & ~3u, block_size),
+          rom(rom_size, rom_content != NULL ? rom_content : zeroContent(rom_size), rom_content == NULL),
+          prefetch(prefetch_depth, rom.size(), latency_rom > 0 ? latency_rom : 3), in_order(in_order), slots(outstanding)
+    {
+        LOG_INFO(LOG_MC, "ROM size is: %d Bytes, bis zu %u offene Anfragen (%s).", rom_size, outstanding,
+                 in_order ? "in Reihenfolge" : "außer der Reihe");
+        SC_THREAD(process);
+        sensitive << clk.pos();
+    }
+
+    void process()
+    {
+        req_ready.write(true);
+        while (true)
+        {
+            wait();
+            cycle++;
+
+            if (mem_resp_valid.read())
+            {
+                Slot &s = slots[mem_resp_tag.read()];
+                uint32_t raw = mem_resp_rdata.read();
+                s.data = s.narrow ? MEMORY_CONTROLLER::byteOf(raw, s.offset) : raw;
+                s.done = true;
+                s.ready_at = cycle;
+            }
+
+            mem_valid.write(false);
+            if (req_valid.read() && req_ready.read())
+            {
+                accept();
+            }
+
+            respond();
+
+            uint32_t used = 0;
+            for (const Slot &s : slots)
+            {
+                used += s.used ? 1 : 0;
+            }
+            req_ready.write(used < slots.size());
+        }
+    }
+
+private:
+    struct Slot
+    {
+        bool used = false;
+        bool done = false;
+        bool error = false;
+        bool narrow = false; // 1-Byte-Lesezugriff auf den Hauptspeicher
+        uint8_t offset = 0;
+        uint8_t tag = 0;
+        uint64_t seq = 0;
+        uint64_t ready_at = 0; // Takt, ab dem die Antwort ausgegeben werden darf
+        uint32_t data = 0;
+    };
+
+    bool in_order;
+    std::vector<Slot> slots;
+    uint64_t cycle = 0;
+    uint64_t seq = 0;
+
+    static uint32_t *zeroContent(uint32_t rom_size)
+    {
+        return static_cast<uint32_t *>(calloc(rom_size / sizeof(uint32_t) + 1, sizeof(uint32_t)));
+    }
+
+    void accept()
+    {
+        size_t id = 0;
+        while (slots[id].used)
+        {
+            id++;
+        }
+        Slot &s = slots[id];
+        s = Slot();
+        s.used = true;
+        s.tag = req_tag.read();
+        s.seq = seq++;
+
+        uint32_t address = req_addr.read();
+        bool write = req_w.read();
+        bool wide = req_wide.read();
+        LOG_DEBUG(LOG_MC, "Anfrage %u angenommen: %s addr=0x%08X, wide=%d, user=%u", s.tag, write ? "WRITE" : "READ",
+                  address, wide, req_user.read());
+
+        denied[s.tag] = !schutz.check(address, req_user.read(), write);
+        if (denied[s.tag])
+        {
+            finish(s, true, 0, cycle);
+        }
+        else if (address < rom.size())
+        {
+            // Wie in MEMORY_CONTROLLER::read()
+            if ((wide && rom.size() < 4) || address > rom.size() - 4)
+            {
+                LOG_INFO(LOG_MC, "Fehler ohne Unterbrechung: Adresse 0x%08X beim ROM-Zugriff liegt außerhalb des gültigen Bereichs bei 4-Byte-Alignment.", address);
+                finish(s, true, 0, cycle);
+            }
+            else if (wide && address % 4 != 0)
+            {
+                LOG_INFO(LOG_MC, "Bei einem 4-Byte-weiten Lesezugriff ist die Adresse 0x%08x nicht 4-Byte aligned.", address);
+                finish(s, true, 0, cycle + prefetch.access(address, cycle));
+            }
+            else
+            {
+                uint32_t value = rom[address];
+                for (uint32_t i = 1; wide && i < 4; i++)
+                {
+                    value |= static_cast<uint32_t>(rom[address + i]) << (8 * i);
+                }
+                finish(s, false, value, cycle + prefetch.access(address, cycle));
+            }
+        }
+        else
+        {
+            uint32_t offset = address % 4;
+            uint32_t wdata = req_wdata.read();
+            s.narrow = !write && !wide;
+            s.offset = static_cast<uint8_t>(offset);
+            mem_valid.write(true);
+            mem_write.write(write);
+            mem_tag.write(static_cast<uint8_t>(id));
+            // 1-Byte-Schreibzugriffe wie in MEMORY_CONTROLLER an der nicht ausgerichteten Adresse
+            mem_addr.write(wide || write ? address : address - offset);
+            mem_wdata.write(wide ? wdata : (wdata & 0xFF) << (offset * 8));
+            mem_be.write(wide ? 0xF : 1 << offset);
+        }
+
+        uint32_t used = 0;
+        for (const Slot &slot : slots)
+        {
+            used += slot.used ? 1 : 0;
+        }
+        max_outstanding = used > max_outstanding ? used : max_outstanding;
+    }
+
+    void finish(Slot & s, bool error, uint32_t data, uint64_t ready_at)
+    {
+        s.done = true;
+        s.error = error;
+        s.data = data;
+        s.ready_at = ready_at;
+    }
+
+    // Gibt höchstens eine Antwort pro Takt aus.
+    void respond()
+    {
+        Slot *next = nullptr;
+        for (Slot &s : slots)
+        {
+            if (!s.used)
+            {
+                continue;
+            }
+            if (in_order)
+            {
+                if (next == nullptr || s.seq < next->seq)
+                {
+                    next = &s;
+                }
+            }
+            else if (s.done && s.ready_at <= cycle &&
+                     (next == nullptr || s.ready_at < next->ready_at || (s.ready_at == next->ready_at && s.seq < next->seq)))
+            {
+                next = &s;
+            }
+        }
+
+        if (next == nullptr || !next->done || next->ready_at > cycle)
+        {
+            resp_valid.write(false);
+            return;
+        }
+        resp_valid.write(true);
+        resp_error.write(next->error);
+        resp_tag.write(next->tag);
+        resp_rdata.write(next->data);
+        next->used = false;
+    }
+};
+
+#endif // PIPELINED_CONTROLLER_HPP
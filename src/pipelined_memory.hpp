@@ -0,0 +1,129 @@
+#ifndef PIPELINED_MEMORY_HPP
+#define PIPELINED_MEMORY_HPP
+
+#include <systemc>
+#include <vector>
+
+#include "log.h"
+#include "memory_timing.hpp"
+#include "ram_store.hpp"
+#include "sim_profile.hpp"
+using namespace sc_core;
+
+// Hauptspeicher für den Split-Transaction-Modus (--mode pipelined): Nimmt in jedem Takt einen
+// Befehl an (cmd_valid) und antwortet nach dessen Latenz mit dem gleichen Tag. Es ist immer
+// höchstens eine Antwort pro Takt sichtbar; sind mehrere fällig, kommt die älteste zuerst. Mit
+// dem DRAM-Modell haben Befehle unterschiedliche Latenzen, die Antworten können sich also
+// überholen. Die Daten werden bei der Annahme gelesen bzw. geschrieben, Befehle wirken damit in
+// der Reihenfolge ihrer Annahme.
+SC_MODULE(PIPELINED_MEMORY), public ActivityCounter
+{
+  sc_in<bool> clk;
+
+  sc_in<bool> cmd_valid;
+  sc_in<bool> cmd_write;
+  sc_in<uint8_t> cmd_tag;
+  sc_in<uint8_t> cmd_be; // Byte-Enable für Schreibbefehle
+  sc_in<uint32_t> cmd_addr;
+  sc_in<uint32_t> cmd_wdata;
+
+  sc_out<bool> resp_valid;
+  sc_out<uint8_t> resp_tag;
+  sc_out<uint32_t> resp_rdata;
+
+  RamStore memory;
+  MemoryTiming timing;
+  // Höchstzahl gleichzeitig laufender Befehle
+  uint32_t max_in_flight = 0;
+
+  SC_HAS_PROCESS(PIPELINED_MEMORY);
+  // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+  PROFILED_WAIT
+
+  PIPELINED_MEMORY(sc_module_name name, uint32_t latency_clk, const MemoryTiming::DramParams *dram = nullptr)
+      : sc_module(name), timing(dram != nullptr ? MemoryTiming(*dram) : MemoryTiming(latency_clk > 0 ? latency_clk : MEM_DEFAULT_LATENCY))
+  {
+    SC_THREAD(behaviour);
+    sensitive << clk.pos();
+  }
+
+  void behaviour()
+  {
+    while (true)
+    {
+      wait();
+      cycle++;
+
+      if (cmd_valid.read())
+      {
+        accept();
+      }
+
+      // Die fälligste Antwort ausgeben
+      size_t best = pending.size();
+      for (size_t i = 0; i < pending.size(); i++)
+      {
+        const Pending &p = pending[i];
+        if (p.due <= cycle && (best == pending.size() || p.due < pending[best].due ||
+                               (p.due == pending[best].due && p.seq < pending[best].seq)))
+        {
+          best = i;
+        }
+      }
+      if (best < pending.size())
+      {
+        resp_valid.write(true);
+        resp_tag.write(pending[best].tag);
+        resp_rdata.write(pending[best].data);
+        pending[best] = pending.back();
+        pending.pop_back();
+      }
+      else
+      {
+        resp_valid.write(false);
+      }
+    }
+  }
+
+  uint32_t residentPages()
+  {
+    return memory.residentPages();
+  }
+
+private:
+  struct Pending
+  {
+    uint64_t due; // Takt, ab dem die Antwort ausgegeben werden darf
+    uint64_t seq;
+    uint8_t tag;
+    uint32_t data;
+  };
+
+  std::vector<Pending> pending;
+  uint64_t cycle = 0;
+  uint64_t seq = 0;
+
+  void accept()
+  {
+    uint32_t address = cmd_addr.read();
+    uint32_t data = 0;
+    if (cmd_write.read())
+    {
+      memory.writeWordMasked(address, cmd_wdata.read(), cmd_be.read());
+      LOG_DEBUG(LOG_MEM, "Befehl %u: 0x%08x an Adresse 0x%08x geschrieben (Byte-Enable 0x%X).",
+                cmd_tag.read(), cmd_wdata.read(), address, cmd_be.read() & 0xF);
+    }
+    else
+    {
+      data = memory.readWord(address);
+      LOG_DEBUG(LOG_MEM, "Befehl %u: 0x%08x an Adresse 0x%08x gelesen.", cmd_tag.read(), data, address);
+    }
+    pending.push_back(Pending{cycle + timing.access(address), seq++, cmd_tag.read(), data});
+    if (pending.size() > max_in_flight)
+    {
+      max_in_flight = static_cast<uint32_t>(pending.size());
+    }
+  }
+};
+
+#endif // PIPELINED_MEMORY_HPP
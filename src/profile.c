@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <time.h>
+#include "profile.h"
+
+static const char *phase_names[PROFILE_PHASE_COUNT] = {
+    "arguments", "rom_load", "requests", "elaboration", "simulation", "trace_close"};
+
+double profile_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+void profile_add(struct SimProfile *profile, enum ProfilePhase phase, double start)
+{
+    if (profile != NULL)
+    {
+        profile->seconds[phase] += profile_now() - start;
+    }
+}
+
+void profile_write_json(FILE *out, const struct SimProfile *profile)
+{
+    double total = 0;
+    fprintf(out, "{\n  \"phases\": {\n");
+    for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+    {
+        total += profile->seconds[i];
+        fprintf(out, "    \"%s\": %.6f,\n", phase_names[i], profile->seconds[i]);
+    }
+    fprintf(out, "    \"total\": %.6f\n  },\n", total);
+
+    fprintf(out, "  \"kernel\": {\"sc_start_calls\": %llu, \"delta_cycles\": %llu},\n",
+            (unsigned long long)profile->sc_starts, (unsigned long long)profile->delta_cycles);
+    fprintf(out, "  \"sampling\": {\"interval_us\": %u, \"samples\": %llu, \"outside_processes\": %llu},\n",
+            profile->sample_us, (unsigned long long)profile->samples, (unsigned long long)profile->kernel_samples);
+
+    fprintf(out, "  \"modules\": {\n");
+    for (uint32_t i = 0; i < profile->module_count; i++)
+    {
+        const struct ModuleProfile *m = &profile->modules[i];
+        fprintf(out, "    \"%s\": {\"activations\": %llu, \"samples\": %llu, \"share\": %.4f}%s\n", m->name,
+                (unsigned long long)m->activations, (unsigned long long)m->samples,
+                profile->samples > 0 ? (double)m->samples / profile->samples : 0.0,
+                i + 1 < profile->module_count ? "," : "");
+    }
+    fprintf(out, "  }\n}\n");
+}
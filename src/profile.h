@@ -0,0 +1,62 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // Abschnitte eines Laufs, deren Wanduhrzeit --profile misst
+    enum ProfilePhase
+    {
+        PROFILE_ARGUMENTS = 0, // Kommandozeile auswerten
+        PROFILE_ROM_LOAD,      // ROM-Inhalt laden
+        PROFILE_REQUESTS,      // CSV parsen, Binär-Trace einblenden oder Last erzeugen
+        PROFILE_ELABORATION,   // Module anlegen und verbinden
+        PROFILE_SIMULATION,    // sc_start() und Testbench
+        PROFILE_TRACE_CLOSE,   // Trace-Datei schließen
+        PROFILE_PHASE_COUNT
+    };
+
+#define PROFILE_MAX_MODULES 32
+
+    // Je Modul mit SC_THREADs oder SC_METHODs (siehe sim_profile.hpp)
+    struct ModuleProfile
+    {
+        char name[64];
+        uint64_t activations; // Rückkehr aus wait() bzw. Aufrufe einer SC_METHOD
+        uint64_t samples;     // Stichproben, in denen ein Prozess des Moduls lief
+    };
+
+    // Ergebnis von --profile. Der Aufrufer legt die Struktur genullt an und übergibt sie über
+    // SimOptions.profile; die Simulation trägt Ausarbeitung, Simulation, Trace und die Zähler des
+    // SystemC-Kerns ein.
+    struct SimProfile
+    {
+        double seconds[PROFILE_PHASE_COUNT];
+        uint64_t delta_cycles;   // sc_delta_count() am Ende
+        uint64_t sc_starts;      // Aufrufe von sc_start()
+        uint32_t sample_us;      // Abstand der Stichproben in Mikrosekunden Prozessorzeit
+        uint64_t samples;        // alle Stichproben während der Simulation
+        uint64_t kernel_samples; // davon ohne laufenden Prozess (Scheduler, Testbench, Trace)
+        uint32_t module_count;
+        struct ModuleProfile modules[PROFILE_MAX_MODULES];
+    };
+
+    // Monotone Uhr in Sekunden
+    double profile_now(void);
+
+    // Zählt die Zeit seit start (von profile_now()) zum Abschnitt phase. profile darf NULL sein.
+    void profile_add(struct SimProfile *profile, enum ProfilePhase phase, double start);
+
+    // Schreibt Abschnitte, Kernzähler und Module als JSON.
+    void profile_write_json(FILE *out, const struct SimProfile *profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILE_H
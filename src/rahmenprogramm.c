@@ -4,26 +4,275 @@
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include "rahmenprogramm.h"
+#include "log.h"
+#include "request_trace.h"
+#include "rom_loader.h"
+#include "sweep.h"
+#include "bench.h"
+#include "workload.h"
+#include "sim_session.h"
+#include "latency_stats.h"
+#include "profile.h"
 
 #define DEFAULT_CYCLES 100000
+#define DEFAULT_BENCH "seq;stride;random;zipf;contention"
+#define DEFAULT_BENCH_SIZES "1000:10000000:*10"
 #define DEFAULT_LATENCY_ROM 1
 #define DEFAULT_ROM_SIZE 0x100000
 #define DEFAULT_BLOCK_SIZE 0x1000 // Both examples from pdf data
 
 void print_help(const char *prog_name)
 {
-    fprintf(stderr, "Verwendung: %s [Optionen] <Eingabedatei>\n\n", prog_name);
+    fprintf(stderr, "Verwendung: %s [Optionen] <Eingabedatei (.csv oder Binär-Trace .bin)>\n\n", prog_name);
     fprintf(stderr, "Optionen:\n");
     fprintf(stderr, "  --cycles <Zahl>          Anzahl der Zyklen (Standard: %d)\n", DEFAULT_CYCLES);
     fprintf(stderr, "  --tf <Zeichenkette>      Pfad zur Trace-Datei\n");
     fprintf(stderr, "  --latency-rom <Zahl>     Latenz der ROM (Standard: %d)\n", DEFAULT_LATENCY_ROM);
     fprintf(stderr, "  --rom-size <Zahl>        Größe der ROM in Bytes (Standard: %#x)\n", DEFAULT_ROM_SIZE);
     fprintf(stderr, "  --block-size <Zahl>      Größe eines Speicherblocks in Bytes (Standard: %#x)\n", DEFAULT_BLOCK_SIZE);
+    fprintf(stderr, "  --latency-mem <Zahl>     Latenz des Hauptspeichers ohne DRAM-Modell, ab 1 (Standard: %d)\n", MEM_DEFAULT_LATENCY);
+    fprintf(stderr, "  --dram                   Hauptspeicher als DRAM mit Bänken und offenen Zeilen statt fester Latenz\n");
+    fprintf(stderr, "  --dram-banks <Zahl>      Anzahl der Bänke (Standard: %d)\n", DRAM_DEFAULT_BANKS);
+    fprintf(stderr, "  --dram-row-size <Zahl>   Bytes je Zeile (Standard: %d)\n", DRAM_DEFAULT_ROW_SIZE);
+    fprintf(stderr, "  --dram-trcd <Zahl>, --dram-tcas <Zahl>, --dram-trp <Zahl>\n");
+    fprintf(stderr, "                           Takte für Zeile öffnen, Spaltenzugriff, Zeile schließen (Standard: %d, %d, %d)\n",
+            DRAM_DEFAULT_T_RCD, DRAM_DEFAULT_T_CAS, DRAM_DEFAULT_T_RP);
+    fprintf(stderr, "  --ram <paged|sparse|file:<Pfad>>\n");
+    fprintf(stderr, "                           Inhalt des Hauptspeichers: Seitentabelle, eingeblendeter 4-GiB-Bereich\n");
+    fprintf(stderr, "                           (belegt nur berührte Seiten) oder derselbe Bereich in einer Datei, die\n");
+    fprintf(stderr, "                           danach das Speicherabbild enthält (Standard: paged)\n");
     fprintf(stderr, "  --rom-content <Pfad>     Pfad zum ROM-Inhalt\n");
+    fprintf(stderr, "  --rom-format <auto|text|bin|hex|elf>\n");
+    fprintf(stderr, "                           Format des ROM-Inhalts: eine Zahl je Zeile, Rohabbild, Intel HEX\n");
+    fprintf(stderr, "                           oder ELF-Segmente; bin und elf werden ohne Kopie eingeblendet\n");
+    fprintf(stderr, "                           (Standard: auto nach ELF-Kennung und Endung .bin/.img/.hex/.ihex)\n");
+    fprintf(stderr, "  --rom-prefetch <Zahl>    Zeilenpuffer vor dem ROM, der bei sequentiellen und gleichmäßig\n");
+    fprintf(stderr, "                           versetzten Zugriffen so viele Zeilen vorausliest (Standard: 0 = aus,\n");
+    fprintf(stderr, "                           max. %d)\n", ROM_PREFETCH_MAX_DEPTH);
+    fprintf(stderr, "  --log-level <Angabe>     Log-Stufe (off, error, warn, info, debug, trace), global oder\n");
+    fprintf(stderr, "                           je Modul, z.B. \"info,mc=debug,mem=trace\" (Module: mc, mem, rom, tb;\n");
+    fprintf(stderr, "                           Standard: warn)\n");
+    fprintf(stderr, "  --mode <signal|lt|pipelined>\n");
+    fprintf(stderr, "                           Simulationsmodell: signalgenau, TLM loosely-timed oder signalgenau mit\n");
+    fprintf(stderr, "                           mehreren offenen Anfragen (Split-Transaction, Standard: signal)\n");
+    fprintf(stderr, "  --outstanding <Zahl>     Höchstzahl offener Anfragen bei pipelined (Standard: %d, max. %d)\n",
+            PIPELINE_DEFAULT_OUTSTANDING, PIPELINE_MAX_OUTSTANDING);
+    fprintf(stderr, "  --completion <inorder|ooo>\n");
+    fprintf(stderr, "                           Antworten bei pipelined in Reihenfolge der Anfragen oder sobald\n");
+    fprintf(stderr, "                           sie fertig sind (Standard: inorder)\n");
+    fprintf(stderr, "  --processes <thread|method>\n");
+    fprintf(stderr, "                           Controller, Hauptspeicher und ROM als SC_THREADs oder als\n");
+    fprintf(stderr, "                           Zustandsautomaten in SC_METHODs ohne Kontextwechsel; method ist\n");
+    fprintf(stderr, "                           experimentell, der Abgleich der Takte mit thread steht in\n");
+    fprintf(stderr, "                           testcase/regression.sh (nur --mode signal, Standard: thread)\n");
+    fprintf(stderr, "  --store-buffer <Zahl>    Schreibpuffer im Controller mit so vielen Zeilen: fasst Schreibzugriffe\n");
+    fprintf(stderr, "                           auf dieselbe Zeile zusammen, beantwortet Lesezugriffe auf gepufferte\n");
+    fprintf(stderr, "                           Bytes und schreibt im Leerlauf oder wenn er voll ist\n");
+    fprintf(stderr, "                           (nur --mode signal, Standard: 0 = aus, max. %d)\n", STORE_BUFFER_MAX_ENTRIES);
+    fprintf(stderr, "  --store-buffer-line <Zahl>\n");
+    fprintf(stderr, "                           Bytes je Zeile des Schreibpuffers (Standard: %d)\n", STORE_BUFFER_DEFAULT_LINE);
+    fprintf(stderr, "  --byte-enable            1-Byte-Schreibzugriffe mit Byte-Enable in einem Speicherzugriff;\n");
+    fprintf(stderr, "                           gibt zusätzlich die Ersparnis gegenüber Read-Modify-Write aus.\n");
+    fprintf(stderr, "                           Das Byte landet wie ohne die Option an Adresse + Adresse %% 4\n");
+    fprintf(stderr, "  --cache-size <Zahl>      Cache vor dem Hauptspeicher mit dieser Größe in Bytes (Standard: 0 = aus)\n");
+    fprintf(stderr, "  --cache-line <Zahl>      Zeilengröße des Caches in Bytes (Standard: %d)\n", CACHE_DEFAULT_LINE);
+    fprintf(stderr, "  --cache-assoc <Zahl>     Assoziativität des Caches (Standard: %d)\n", CACHE_DEFAULT_ASSOC);
+    fprintf(stderr, "  --cache-replacement <lru|plru|random>\n");
+    fprintf(stderr, "                           Ersetzungsstrategie des Caches (Standard: lru)\n");
+    fprintf(stderr, "  --cache-write <back|through>\n");
+    fprintf(stderr, "                           Schreibstrategie des Caches (Standard: back)\n");
+    fprintf(stderr, "  --split-users            Anfragen nach Benutzer auf gleichzeitige Master mit eigener\n");
+    fprintf(stderr, "                           Warteschlange aufteilen (nur --mode signal)\n");
+    fprintf(stderr, "  --arbitration <rr|priority|weighted>\n");
+    fprintf(stderr, "                           Auswahl zwischen den Mastern (Standard: rr; priority: kleinere\n");
+    fprintf(stderr, "                           Benutzer-ID zuerst)\n");
+    fprintf(stderr, "  --master-queue <Zahl>    Plätze der Warteschlange je Master (Standard: %d)\n", MASTER_DEFAULT_QUEUE);
+    fprintf(stderr, "  --master-weights <Liste> Gewichte für weighted, z.B. \"1:4,2:1\" (Benutzer:Gewicht, Standard: 1)\n");
+    fprintf(stderr, "  --convert <Pfad>         Anfragen als Binär-Trace (.bin) speichern und nicht simulieren\n");
+    fprintf(stderr, "  --delta                  Binär-Trace mit Delta-Kodierung der Adressen (kleiner, wird beim\n");
+    fprintf(stderr, "                           Laden dekodiert statt direkt eingeblendet)\n");
+    fprintf(stderr, "  --verify-trace           Prüfsumme der Nutzdaten eines Binär-Traces vor dem Lauf prüfen\n");
+    fprintf(stderr, "                           (liest die ganze Datei; bei --convert und delta-kodierten Traces immer)\n");
+    fprintf(stderr, "  --sweep-latency-rom <Liste>, --sweep-block-size <Liste>, --sweep-rom-size <Liste>\n");
+    fprintf(stderr, "                           Alle Kombinationen parallel simulieren. Liste: \"1,2,4\", \"1:8\",\n");
+    fprintf(stderr, "                           \"0:64:16\" (Schritt) oder \"256:4096:*2\" (Faktor)\n");
+    fprintf(stderr, "  --sweep-out <Pfad>       Ergebnistabelle des Sweeps (.csv oder .json, Standard: stdout)\n");
+    fprintf(stderr, "  --jobs <Zahl>            Höchstzahl gleichzeitiger Simulationen im Sweep (Standard: CPUs)\n");
+    fprintf(stderr, "  --trace-start <Takt>     Trace-Datei erst ab diesem Takt schreiben\n");
+    fprintf(stderr, "  --trace-end <Takt|+Anzahl>\n");
+    fprintf(stderr, "                           Trace-Datei ab diesem Takt bzw. nach so vielen Takten schließen\n");
+    fprintf(stderr, "  --trace-trigger <req:Nummer|addr:Von[-Bis]>\n");
+    fprintf(stderr, "                           Aufzeichnung erst ab dieser Anfrage bzw. dem ersten Zugriff auf\n");
+    fprintf(stderr, "                           den Adressbereich beginnen\n");
+    fprintf(stderr, "  --trace-signals <Liste>  Nur diese Signale oder Gruppen aufzeichnen (cu, mem, ram, rom,\n");
+    fprintf(stderr, "                           all, Signalnamen; clk nur auf Wunsch, Standard: all)\n");
+    fprintf(stderr, "  --trace-writer <systemc|async>\n");
+    fprintf(stderr, "                           async: Trace im Hintergrund-Thread schreiben (Standard: systemc,\n");
+    fprintf(stderr, "                           bei --tf <Pfad>.vcd.gz immer async und gzip-komprimiert, mit\n");
+    fprintf(stderr, "                           Index der Einstiegspunkte in <Pfad>.vcd.gz.idx)\n");
+    fprintf(stderr, "  --stats <Pfad>           Takte je Anfrage als Histogramm (p50/p90/p99/max) nach Art\n");
+    fprintf(stderr, "                           der Anfrage und Benutzer als JSON speichern\n");
+    fprintf(stderr, "  --profile <Pfad>         Wanduhrzeit je Abschnitt (Argumente, ROM, Anfragen, Ausarbeitung,\n");
+    fprintf(stderr, "                           Simulation, Trace), Delta-Zyklen und Aktivierungen und Anteil der\n");
+    fprintf(stderr, "                           Prozessorzeit je Modul als JSON speichern (nicht mit --bench, Sweep)\n");
+    fprintf(stderr, "  --workload <Angabe>      Synthetische Last statt Eingabedatei, z.B. \"zipf:n=100000,theta=0.9\"\n");
+    fprintf(stderr, "                           (seq, stride, random, zipf, contention; Schlüssel n, base, size,\n");
+    fprintf(stderr, "                           stride, wide, write, user, users, shared, block, theta, seed;\n");
+    fprintf(stderr, "                           base standardmäßig hinter der ROM)\n");
+    fprintf(stderr, "  --chunk <Zahl>           --workload in Stapeln dieser Größe erzeugen und ohne Zyklengrenze in\n");
+    fprintf(stderr, "                           einer Sitzung simulieren; der Speicherbedarf hängt nicht von n ab\n");
+    fprintf(stderr, "                           (nur --mode signal, ohne --split-users)\n");
+    fprintf(stderr, "  --bench[=<Lasten>]       Jede Last (getrennt durch ';', Standard: \"%s\")\n", DEFAULT_BENCH);
+    fprintf(stderr, "                           mit jeder Anzahl aus --bench-sizes simulieren und Anfragen/s,\n");
+    fprintf(stderr, "                           Takte je Anfrage und höchsten RSS ausgeben\n");
+    fprintf(stderr, "  --bench-sizes <Liste>    Anzahlen der Anfragen (Standard: \"%s\")\n", DEFAULT_BENCH_SIZES);
     fprintf(stderr, "  --help                   Diese Hilfemeldung anzeigen\n");
 }
 
+static bool has_extension(const char *filename, const char *extension)
+{
+    size_t len = strlen(filename);
+    size_t ext_len = strlen(extension);
+    return len >= ext_len && strcmp(filename + len - ext_len, extension) == 0;
+}
+
+static bool is_power_of_two(uint32_t value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Gibt 0 zurück, wenn die Cache-Parameter zusammenpassen (oder kein Cache gewählt ist).
+static int check_cache_options(const MemConfig *config)
+{
+    const struct SimOptions *o = &config->options;
+    if (o->cache_size == 0)
+    {
+        return 0;
+    }
+    if (config->mode != MODE_SIGNAL)
+    {
+        fprintf(stderr, "Der Cache ist nur im signalgenauen Modell (--mode signal) verfügbar.\n");
+        return 1;
+    }
+    if (!is_power_of_two(o->cache_size) || !is_power_of_two(o->cache_line) || !is_power_of_two(o->cache_assoc))
+    {
+        fprintf(stderr, "Cache-Größe, Zeilengröße und Assoziativität müssen Zweierpotenzen sein.\n");
+        return 1;
+    }
+    if (o->cache_line < 4)
+    {
+        fprintf(stderr, "Die Zeilengröße des Caches muss mindestens 4 Bytes betragen.\n");
+        return 1;
+    }
+    if ((uint64_t)o->cache_line * o->cache_assoc > o->cache_size)
+    {
+        fprintf(stderr, "Der Cache muss mindestens einen Satz (Zeilengröße * Assoziativität) fassen.\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Gibt 0 zurück, wenn die Parameter des DRAM-Modells zusammenpassen (oder es nicht gewählt ist).
+static int check_dram_options(const MemConfig *config)
+{
+    const struct SimOptions *o = &config->options;
+    if (!o->dram)
+    {
+        return 0;
+    }
+    if (!is_power_of_two(o->dram_banks) || !is_power_of_two(o->dram_row_size) || o->dram_row_size < 4)
+    {
+        fprintf(stderr, "Bankanzahl und Zeilengröße des DRAMs müssen Zweierpotenzen sein (Zeile mindestens 4 Bytes).\n");
+        return 1;
+    }
+    if (o->dram_t_rcd == 0 || o->dram_t_cas == 0 || o->dram_t_rp == 0)
+    {
+        fprintf(stderr, "Die DRAM-Zeiten müssen mindestens einen Takt betragen.\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Gibt 0 zurück, wenn die Optionen für mehrere Master zusammenpassen.
+static int check_master_options(const MemConfig *config)
+{
+    if (config->options.split_users && config->mode != MODE_SIGNAL)
+    {
+        fprintf(stderr, "Mehrere Master sind nur im signalgenauen Modell (--mode signal) verfügbar.\n");
+        return 1;
+    }
+    if (config->options.master_queue == 0)
+    {
+        fprintf(stderr, "Die Warteschlange eines Masters muss mindestens einen Platz haben.\n");
+        return 1;
+    }
+    return 0;
+}
+
+// Liest eine Liste "Benutzer:Gewicht,..." mit Gewichten von 1 bis 255. Gibt 0 bei Erfolg zurück.
+static int parse_master_weights(const char *spec, uint8_t *weights)
+{
+    const char *item = spec;
+    while (*item != '\0')
+    {
+        const char *end = strchr(item, ',');
+        size_t len = end ? (size_t)(end - item) : strlen(item);
+        const char *colon = memchr(item, ':', len);
+        uint32_t user, weight;
+        if (colon == NULL || parse_number_n(item, colon - item, &user) != 0 ||
+            parse_number_n(colon + 1, item + len - (colon + 1), &weight) != 0 ||
+            user > 255 || weight == 0 || weight > 255)
+        {
+            return 1;
+        }
+        weights[user] = (uint8_t)weight;
+        item += len;
+        if (*item == ',')
+        {
+            item++;
+        }
+    }
+    return 0;
+}
+
+// Liest "req:<Nummer>", "addr:<Adresse>" oder "addr:<Von>-<Bis>". Gibt 0 bei Erfolg zurück.
+static int parse_trace_trigger(const char *spec, struct SimOptions *o)
+{
+    if (strncmp(spec, "req:", 4) == 0)
+    {
+        o->trace_trigger = TRACE_TRIGGER_REQUEST;
+        return parse_number(spec + 4, &o->trace_trigger_index);
+    }
+    if (strncmp(spec, "addr:", 5) == 0)
+    {
+        const char *range = spec + 5;
+        const char *dash = strchr(range, '-');
+        o->trace_trigger = TRACE_TRIGGER_ADDRESS;
+        if (dash == NULL)
+        {
+            if (parse_number(range, &o->trace_trigger_lo) != 0)
+            {
+                return 1;
+            }
+            o->trace_trigger_hi = o->trace_trigger_lo;
+            return 0;
+        }
+        if (parse_number_n(range, dash - range, &o->trace_trigger_lo) != 0 ||
+            parse_number(dash + 1, &o->trace_trigger_hi) != 0)
+        {
+            return 1;
+        }
+        return o->trace_trigger_lo <= o->trace_trigger_hi ? 0 : 1;
+    }
+    return 1;
+}
+
 int parse_arguments(int argc, char *argv[], MemConfig *config)
 {
 
@@ -37,6 +286,52 @@ int parse_arguments(int argc, char *argv[], MemConfig *config)
         {"rom-size", required_argument, 0, 's'},
         {"block-size", required_argument, 0, 'b'},
         {"rom-content", required_argument, 0, 'r'},
+        {"rom-format", required_argument, 0, 'f'},
+        {"rom-prefetch", required_argument, 0, 'p'},
+        {"latency-mem", required_argument, 0, 'M'},
+        {"dram", no_argument, 0, 'D'},
+        {"dram-banks", required_argument, 0, 'K'},
+        {"dram-row-size", required_argument, 0, 'R'},
+        {"dram-trcd", required_argument, 0, 'x'},
+        {"dram-tcas", required_argument, 0, 'y'},
+        {"dram-trp", required_argument, 0, 'z'},
+        {"log-level", required_argument, 0, 'L'},
+        {"mode", required_argument, 0, 'm'},
+        {"outstanding", required_argument, 0, 'n'},
+        {"completion", required_argument, 0, 'i'},
+        {"byte-enable", no_argument, 0, 'e'},
+        {"cache-size", required_argument, 0, 'C'},
+        {"cache-line", required_argument, 0, 'Z'},
+        {"cache-assoc", required_argument, 0, 'A'},
+        {"cache-replacement", required_argument, 0, 'P'},
+        {"cache-write", required_argument, 0, 'W'},
+        {"split-users", no_argument, 0, 'u'},
+        {"arbitration", required_argument, 0, 'a'},
+        {"master-queue", required_argument, 0, 'q'},
+        {"master-weights", required_argument, 0, 'k'},
+        {"convert", required_argument, 0, 'o'},
+        {"delta", no_argument, 0, 'd'},
+        {"verify-trace", no_argument, 0, 'V'},
+        {"sweep-latency-rom", required_argument, 0, '1'},
+        {"sweep-block-size", required_argument, 0, '2'},
+        {"sweep-rom-size", required_argument, 0, '3'},
+        {"sweep-out", required_argument, 0, 'O'},
+        {"jobs", required_argument, 0, 'j'},
+        {"stats", required_argument, 0, 'S'},
+        {"trace-start", required_argument, 0, 'T'},
+        {"trace-end", required_argument, 0, 'E'},
+        {"trace-trigger", required_argument, 0, 'G'},
+        {"trace-signals", required_argument, 0, 'g'},
+        {"trace-writer", required_argument, 0, 'w'},
+        {"workload", required_argument, 0, 'v'},
+        {"bench", optional_argument, 0, 'B'},
+        {"bench-sizes", required_argument, 0, 'N'},
+        {"chunk", required_argument, 0, 'J'},
+        {"processes", required_argument, 0, 'F'},
+        {"ram", required_argument, 0, 'X'},
+        {"store-buffer", required_argument, 0, 'Y'},
+        {"store-buffer-line", required_argument, 0, 'I'},
+        {"profile", required_argument, 0, 'U'},
         {"help", no_argument, 0, 'h'},
         {0, 0, 0, 0}};
 
@@ -46,10 +341,38 @@ int parse_arguments(int argc, char *argv[], MemConfig *config)
     config->inputfile = NULL;
     config->latency_rom = DEFAULT_LATENCY_ROM;
     config->rom_content_file = NULL;
+    config->rom_format = ROM_FORMAT_AUTO;
     config->rom_size = DEFAULT_ROM_SIZE;
     config->tracefile = NULL;
+    config->convert_file = NULL;
+    config->convert_delta = 0;
+    config->verify_trace = 0;
+    config->sweep_latency_rom = NULL;
+    config->sweep_block_size = NULL;
+    config->sweep_rom_size = NULL;
+    config->sweep_out = NULL;
+    config->jobs = 0;
+    config->stats_file = NULL;
+    config->profile_file = NULL;
+    config->workload = NULL;
+    config->bench = NULL;
+    config->bench_sizes = NULL;
+    config->chunk = 0;
+    config->mode = MODE_SIGNAL;
+    memset(&config->options, 0, sizeof(config->options));
+    config->options.cache_line = CACHE_DEFAULT_LINE;
+    config->options.cache_assoc = CACHE_DEFAULT_ASSOC;
+    config->options.latency_mem = MEM_DEFAULT_LATENCY;
+    config->options.dram_banks = DRAM_DEFAULT_BANKS;
+    config->options.dram_row_size = DRAM_DEFAULT_ROW_SIZE;
+    config->options.dram_t_rcd = DRAM_DEFAULT_T_RCD;
+    config->options.dram_t_cas = DRAM_DEFAULT_T_CAS;
+    config->options.dram_t_rp = DRAM_DEFAULT_T_RP;
+    config->options.master_queue = MASTER_DEFAULT_QUEUE;
+    config->options.outstanding = PIPELINE_DEFAULT_OUTSTANDING;
+    config->options.store_buffer_line = STORE_BUFFER_DEFAULT_LINE;
 
-    while ((opt = getopt_long(argc, argv, "c:t:l:s:b:r:h", long_options, &option_index)) != -1)
+    while ((opt = getopt_long(argc, argv, "c:t:l:s:b:r:f:p:M:DK:R:x:y:z:L:m:n:i:eC:Z:A:P:W:ua:q:k:o:d1:2:3:O:j:S:T:E:G:g:w:v:B::N:J:F:X:Y:I:U:Vh", long_options, &option_index)) != -1)
     {
         switch (opt)
         {
@@ -67,10 +390,361 @@ int parse_arguments(int argc, char *argv[], MemConfig *config)
             break;
         case 'b':
             config->block_size = atoi(optarg);
+            if (config->block_size == 0)
+            {
+                // Der Zugriffsschutz teilt den Adressraum oberhalb des ROMs in Blöcke dieser Größe
+                fprintf(stderr, "Die Blockgröße muss größer als 0 sein: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
             break;
         case 'r':
             config->rom_content_file = optarg;
             break;
+        case 'M':
+            config->options.latency_mem = atoi(optarg);
+            if (config->options.latency_mem == 0)
+            {
+                // Im Modell steht 0 für die Standardlatenz; einen Speicher ohne Wartetakt gibt es nicht.
+                fprintf(stderr, "Die Speicherlatenz muss mindestens 1 Takt sein: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'D':
+            config->options.dram = 1;
+            break;
+        case 'K':
+            config->options.dram_banks = atoi(optarg);
+            break;
+        case 'R':
+            config->options.dram_row_size = atoi(optarg);
+            break;
+        case 'x':
+            config->options.dram_t_rcd = atoi(optarg);
+            break;
+        case 'y':
+            config->options.dram_t_cas = atoi(optarg);
+            break;
+        case 'z':
+            config->options.dram_t_rp = atoi(optarg);
+            break;
+        case 'L':
+            if (log_set_levels(optarg) != 0)
+            {
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'm':
+            if (strcmp(optarg, "signal") == 0)
+            {
+                config->mode = MODE_SIGNAL;
+            }
+            else if (strcmp(optarg, "lt") == 0)
+            {
+                config->mode = MODE_LT;
+            }
+            else if (strcmp(optarg, "pipelined") == 0)
+            {
+                config->mode = MODE_PIPELINED;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekanntes Simulationsmodell: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'f':
+            if (strcmp(optarg, "auto") == 0)
+            {
+                config->rom_format = ROM_FORMAT_AUTO;
+            }
+            else if (strcmp(optarg, "text") == 0)
+            {
+                config->rom_format = ROM_FORMAT_TEXT;
+            }
+            else if (strcmp(optarg, "bin") == 0)
+            {
+                config->rom_format = ROM_FORMAT_BIN;
+            }
+            else if (strcmp(optarg, "hex") == 0)
+            {
+                config->rom_format = ROM_FORMAT_IHEX;
+            }
+            else if (strcmp(optarg, "elf") == 0)
+            {
+                config->rom_format = ROM_FORMAT_ELF;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekanntes Format des ROM-Inhalts: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'p':
+            if (parse_number(optarg, &config->options.rom_prefetch) != 0 ||
+                config->options.rom_prefetch > ROM_PREFETCH_MAX_DEPTH)
+            {
+                fprintf(stderr, "--rom-prefetch muss zwischen 0 und %d liegen: %s\n", ROM_PREFETCH_MAX_DEPTH, optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'n':
+            if (parse_number(optarg, &config->options.outstanding) != 0 || config->options.outstanding == 0 ||
+                config->options.outstanding > PIPELINE_MAX_OUTSTANDING)
+            {
+                fprintf(stderr, "--outstanding muss zwischen 1 und %d liegen: %s\n", PIPELINE_MAX_OUTSTANDING, optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'i':
+            if (strcmp(optarg, "inorder") == 0)
+            {
+                config->options.out_of_order = 0;
+            }
+            else if (strcmp(optarg, "ooo") == 0)
+            {
+                config->options.out_of_order = 1;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannte Reihenfolge der Antworten: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'e':
+            config->options.byte_enable = 1;
+            break;
+        case 'C':
+            config->options.cache_size = atoi(optarg);
+            break;
+        case 'Z':
+            config->options.cache_line = atoi(optarg);
+            break;
+        case 'A':
+            config->options.cache_assoc = atoi(optarg);
+            break;
+        case 'P':
+            if (strcmp(optarg, "lru") == 0)
+            {
+                config->options.cache_replacement = CACHE_LRU;
+            }
+            else if (strcmp(optarg, "plru") == 0)
+            {
+                config->options.cache_replacement = CACHE_PLRU;
+            }
+            else if (strcmp(optarg, "random") == 0)
+            {
+                config->options.cache_replacement = CACHE_RANDOM;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannte Ersetzungsstrategie: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'W':
+            if (strcmp(optarg, "back") == 0)
+            {
+                config->options.cache_write_through = 0;
+            }
+            else if (strcmp(optarg, "through") == 0)
+            {
+                config->options.cache_write_through = 1;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannte Schreibstrategie: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'u':
+            config->options.split_users = 1;
+            break;
+        case 'a':
+            if (strcmp(optarg, "rr") == 0)
+            {
+                config->options.arbitration = ARBITRATION_ROUND_ROBIN;
+            }
+            else if (strcmp(optarg, "priority") == 0)
+            {
+                config->options.arbitration = ARBITRATION_PRIORITY;
+            }
+            else if (strcmp(optarg, "weighted") == 0)
+            {
+                config->options.arbitration = ARBITRATION_WEIGHTED;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannte Arbitrierung: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'q':
+            config->options.master_queue = atoi(optarg);
+            break;
+        case 'k':
+            if (parse_master_weights(optarg, config->options.master_weight) != 0)
+            {
+                fprintf(stderr, "Ungültige Gewichte für --master-weights: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'o':
+            config->convert_file = optarg;
+            break;
+        case 'd':
+            config->convert_delta = 1;
+            break;
+        case 'V':
+            config->verify_trace = 1;
+            break;
+        case '1':
+            config->sweep_latency_rom = optarg;
+            break;
+        case '2':
+            config->sweep_block_size = optarg;
+            break;
+        case '3':
+            config->sweep_rom_size = optarg;
+            break;
+        case 'O':
+            config->sweep_out = optarg;
+            break;
+        case 'j':
+            config->jobs = atoi(optarg);
+            break;
+        case 'S':
+            config->stats_file = optarg;
+            break;
+        case 'U':
+            config->profile_file = optarg;
+            break;
+        case 'T':
+            if (parse_number(optarg, &config->options.trace_start) != 0)
+            {
+                fprintf(stderr, "Ungültiger Takt für --trace-start: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'E':
+            config->options.trace_end_relative = optarg[0] == '+';
+            if (parse_number(optarg + config->options.trace_end_relative, &config->options.trace_end) != 0 ||
+                config->options.trace_end == 0)
+            {
+                fprintf(stderr, "Ungültiger Takt für --trace-end: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'G':
+            if (parse_trace_trigger(optarg, &config->options) != 0)
+            {
+                fprintf(stderr, "Ungültiger Auslöser für --trace-trigger: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'g':
+            config->options.trace_signals = optarg;
+            break;
+        case 'w':
+            if (strcmp(optarg, "systemc") == 0)
+            {
+                config->options.trace_writer = TRACE_WRITER_SYSTEMC;
+            }
+            else if (strcmp(optarg, "async") == 0)
+            {
+                config->options.trace_writer = TRACE_WRITER_ASYNC;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannter Trace-Writer: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'v':
+            config->workload = optarg;
+            break;
+        case 'B':
+            config->bench = optarg != NULL ? optarg : DEFAULT_BENCH;
+            break;
+        case 'N':
+            config->bench_sizes = optarg;
+            break;
+        case 'J':
+            if (parse_number(optarg, &config->chunk) != 0 || config->chunk == 0)
+            {
+                fprintf(stderr, "Ungültige Stapelgröße für --chunk: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'F':
+            if (strcmp(optarg, "thread") == 0)
+            {
+                config->options.fsm = 0;
+            }
+            else if (strcmp(optarg, "method") == 0)
+            {
+                config->options.fsm = 1;
+            }
+            else
+            {
+                fprintf(stderr, "Unbekannte Prozessart: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'Y':
+            if (parse_number(optarg, &config->options.store_buffer) != 0 ||
+                config->options.store_buffer > STORE_BUFFER_MAX_ENTRIES)
+            {
+                fprintf(stderr, "--store-buffer muss zwischen 0 und %d liegen: %s\n", STORE_BUFFER_MAX_ENTRIES, optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'I':
+            if (parse_number(optarg, &config->options.store_buffer_line) != 0 ||
+                !is_power_of_two(config->options.store_buffer_line) || config->options.store_buffer_line < 4)
+            {
+                fprintf(stderr, "Die Zeilengröße des Schreibpuffers muss eine Zweierpotenz ab 4 sein: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+        case 'X':
+            config->options.ram_mapped = 0;
+            config->options.ram_file = NULL;
+            if (strcmp(optarg, "sparse") == 0)
+            {
+                config->options.ram_mapped = 1;
+            }
+            else if (strncmp(optarg, "file:", 5) == 0 && optarg[5] != '\0')
+            {
+                config->options.ram_mapped = 1;
+                config->options.ram_file = optarg + 5;
+            }
+            else if (strcmp(optarg, "paged") != 0)
+            {
+                fprintf(stderr, "Ungültiger Hauptspeicher für --ram: %s\n", optarg);
+                print_help(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
         case 'h':
             print_help(argv[0]);
             exit(0);
@@ -80,206 +754,591 @@ int parse_arguments(int argc, char *argv[], MemConfig *config)
         }
     }
 
-    if (optind < argc)
+    if (config->tracefile == NULL && (config->options.trace_start != 0 || config->options.trace_end != 0 ||
+                                      config->options.trace_trigger != TRACE_TRIGGER_NONE ||
+                                      config->options.trace_signals != NULL))
+    {
+        fprintf(stderr, "Hinweis: Die --trace-Optionen wirken nur zusammen mit --tf.\n");
+    }
+    if (!config->options.trace_end_relative && config->options.trace_end != 0 &&
+        config->options.trace_end <= config->options.trace_start)
+    {
+        fprintf(stderr, "Fehler: --trace-end muss hinter --trace-start liegen.\n");
+        print_help(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (check_cache_options(config) != 0 || check_dram_options(config) != 0 ||
+        check_master_options(config) != 0)
+    {
+        print_help(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    if (optind < argc)
+    {
+        config->inputfile = argv[optind];
+        // Überprüfen, ob der Dateiname gültig ist und die Endung ".csv" oder ".bin" hat
+        if (!has_extension(config->inputfile, ".csv") && !has_extension(config->inputfile, ".bin"))
+        {
+            // Check whether the name or type of inputfile is valid
+            fprintf(stderr, "Eingabedatei ungültig!\n");
+            print_help(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        fprintf(stderr, "Eingabedatei: %s\n", config->inputfile);
+    }
+    else if (config->workload == NULL && config->bench == NULL)
+    {
+        fprintf(stderr, "Eingabedatei erforderlich!\n");
+        return 1;
+    }
+    if (config->inputfile != NULL && (config->workload != NULL || config->bench != NULL))
+    {
+        fprintf(stderr, "Eingabedatei und --workload bzw. --bench schließen sich aus.\n");
+        return 1;
+    }
+    if (config->bench_sizes != NULL && config->bench == NULL)
+    {
+        fprintf(stderr, "Hinweis: --bench-sizes wirkt nur zusammen mit --bench.\n");
+    }
+    if (config->options.store_buffer > 0 && config->mode != MODE_SIGNAL)
+    {
+        fprintf(stderr, "Der Schreibpuffer ist nur im signalgenauen Modell (--mode signal) verfügbar.\n");
+        return 1;
+    }
+    if (config->options.fsm && config->mode != MODE_SIGNAL)
+    {
+        fprintf(stderr, "--processes method gibt es nur im signalgenauen Modell (--mode signal).\n");
+        return 1;
+    }
+    if (config->options.ram_file != NULL && (config->bench != NULL || config->sweep_latency_rom != NULL ||
+                                             config->sweep_block_size != NULL || config->sweep_rom_size != NULL))
+    {
+        fprintf(stderr, "--ram file: schreibt ein einziges Abbild und geht nicht mit --bench oder Sweep.\n");
+        return 1;
+    }
+    if (config->chunk > 0 && (config->workload == NULL || config->mode != MODE_SIGNAL || config->options.split_users ||
+                              config->sweep_latency_rom != NULL || config->sweep_block_size != NULL ||
+                              config->sweep_rom_size != NULL || config->convert_file != NULL))
+    {
+        fprintf(stderr, "--chunk geht nur mit --workload im signalgenauen Modell, ohne --split-users, Sweep und --convert.\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+int parse_number(const char *str, uint32_t *value)
+{
+    return parse_number_n(str, strlen(str), value);
+}
+
+// Wert einer Ziffer (0-9, a-f, A-F), sonst 16
+static const uint8_t digit_values[256] = {
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16,
+    16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16};
+
+int parse_number_n(const char *str, size_t len, uint32_t *value)
+{
+    const char *end = str + len;
+
+    // Entfernen von Zeilenumbruch/Leerzeichen am Ende
+    while (end > str && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t'))
+    {
+        end--;
+    }
+    // Wie strtoul: Leerraum und Vorzeichen am Anfang
+    while (str < end && (unsigned char)*str <= ' ' && isspace((unsigned char)*str))
+    {
+        str++;
+    }
+    bool negative = false;
+    if (str < end && (*str == '+' || *str == '-'))
+    {
+        negative = *str == '-';
+        str++;
+    }
+
+    // Automatische Erkennung des Zahlensystems (Präfix 0x/0X → hexadezimal, führende 0 → oktal)
+    unsigned base = 10;
+    if (end - str >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X'))
+    {
+        base = 16;
+        str += 2;
+    }
+    else if (end - str >= 1 && str[0] == '0')
+    {
+        base = 8;
+    }
+    if (str == end)
+    {
+        return 1;
+    }
+
+    uint64_t val = 0;
+    for (; str < end; str++)
+    {
+        unsigned digit = digit_values[(unsigned char)*str];
+        if (digit >= base)
+        {
+            return 1;
+        }
+        val = val * base + digit;
+        if (val > UINT32_MAX)
+        {
+            return 1;
+        }
+    }
+    // strtoul liefert für negative Zahlen ungleich 0 Werte oberhalb von UINT32_MAX
+    if (negative && val != 0)
+    {
+        return 1;
+    }
+
+    *value = (uint32_t)val;
+    return 0;
+}
+
+// Textformat: ein 32-Bit-Wort je Zeile. Jede ROM-Größe ist erlaubt; wie in RomImage wird sie auf
+// ganze Wörter aufgerundet, das letzte Wort also vollständig übernommen.
+uint32_t *load_rom_content(const char *filename, uint32_t rom_size)
+{
+    FILE *file = fopen(filename, "r");
+    if (!file)
+    {
+        fprintf(stderr, "Kann ROM-Inhaltsdatei nicht öffnen: %s\n", filename);
+        return NULL;
+    }
+    uint32_t max_entries = (uint32_t)(((uint64_t)rom_size + 3) / 4);
+    uint32_t *content = (uint32_t *)calloc(max_entries + 1, sizeof(uint32_t));
+    if (!content)
+    {
+        fclose(file);
+        return NULL;
+    }
+    char line[256];
+    uint32_t count = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        uint32_t value;
+        if (parse_number(line, &value) != 0)
+        {
+            continue;
+        }
+        if (count == max_entries)
+        {
+            fprintf(stderr, "Der Inhalt der ROM überschreitet die ROM-Größe!\n");
+            free(content);
+            fclose(file);
+            return NULL;
+        }
+        content[count++] = value;
+    }
+    fclose(file);
+    return content;
+}
+
+// Eingabedatei als zusammenhängender, schreibgeschützter Puffer. Reguläre Dateien werden
+// eingeblendet, alles andere (z.B. Pipes) wird vollständig eingelesen.
+struct InputBuffer
+{
+    const char *data;
+    size_t size;
+    void *mapping;
+    char *heap;
+};
+
+static int open_input(const char *filename, struct InputBuffer *buf)
+{
+    memset(buf, 0, sizeof(*buf));
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return 1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+    {
+        buf->size = (size_t)st.st_size;
+        if (buf->size > 0)
+        {
+            buf->mapping = mmap(NULL, buf->size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (buf->mapping == MAP_FAILED)
+            {
+                buf->mapping = NULL;
+                close(fd);
+                return 1;
+            }
+            madvise(buf->mapping, buf->size, MADV_SEQUENTIAL);
+            buf->data = buf->mapping;
+        }
+        close(fd);
+        return 0;
+    }
+
+    size_t capacity = 0;
+    for (;;)
+    {
+        if (buf->size == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 65536;
+            char *grown = realloc(buf->heap, capacity);
+            if (!grown)
+            {
+                free(buf->heap);
+                close(fd);
+                return 1;
+            }
+            buf->heap = grown;
+        }
+        ssize_t got = read(fd, buf->heap + buf->size, capacity - buf->size);
+        if (got < 0)
+        {
+            free(buf->heap);
+            close(fd);
+            return 1;
+        }
+        if (got == 0)
+        {
+            break;
+        }
+        buf->size += (size_t)got;
+    }
+    buf->data = buf->heap;
+    close(fd);
+    return 0;
+}
+
+static void close_input(struct InputBuffer *buf)
+{
+    if (buf->mapping)
+    {
+        munmap(buf->mapping, buf->size);
+    }
+    free(buf->heap);
+}
+
+// Ein Feld einer CSV-Zeile, zeigt direkt in den Eingabepuffer
+struct Field
+{
+    const char *p;
+    size_t len;
+};
+
+// Anfang eines Felds für parse_line_fast(), wahlweise in Anführungszeichen
+static const char *fast_field_start(const char *p, const char *end, bool *quoted)
+{
+    *quoted = p < end && *p == '"';
+    return *quoted ? p + 1 : p;
+}
+
+// Ende eines Felds: schließendes Anführungszeichen, dann ',' bzw. beim letzten Feld das
+// Zeilenende. Liefert den Anfang des nächsten Felds bzw. der nächsten Zeile oder NULL.
+static const char *fast_field_end(const char *p, const char *end, bool quoted, bool last)
+{
+    if (quoted)
+    {
+        if (p == end || *p != '"')
+        {
+            return NULL;
+        }
+        p++;
+    }
+    if (!last)
+    {
+        return p < end && *p == ',' ? p + 1 : NULL;
+    }
+    if (p < end && *p == '\r')
+    {
+        p++;
+    }
+    if (p == end)
+    {
+        return p;
+    }
+    return *p == '\n' ? p + 1 : NULL;
+}
+
+// Zahl wie parse_number_n(), aber nur in den häufigen Formen 0x<hex> und dezimal ohne führende
+// Null. Alles andere (Oktal, Leerraum, Vorzeichen, Überlauf) liefert NULL.
+static const char *fast_number(const char *p, const char *end, uint32_t *value)
+{
+    if (end - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X'))
     {
-        config->inputfile = argv[optind];
-        // Überprüfen, ob der Dateiname gültig ist und die Endung ".csv" hat
-        if (strlen(config->inputfile) < 4 || strcmp(config->inputfile + strlen(config->inputfile) - 4, ".csv") != 0)
+        p += 2;
+        const char *digits = p;
+        while (p < end && *p == '0')
         {
-            // Check whether the name or type of inputfile is valid
-            fprintf(stderr, "Eingabedatei ungültig!\n");
-            print_help(argv[0]);
-            exit(EXIT_FAILURE);
+            p++;
         }
-        fprintf(stderr, "Eingabedatei: %s\n", config->inputfile);
+        const char *significant = p;
+        uint32_t val = 0;
+        unsigned digit;
+        while (p < end && (digit = digit_values[(unsigned char)*p]) < 16)
+        {
+            val = val << 4 | digit;
+            p++;
+        }
+        if (p == digits || p - significant > 8)
+        {
+            return NULL;
+        }
+        *value = val;
+        return p;
     }
-    else
+    if (p < end && *p == '0')
     {
-        fprintf(stderr, "Eingabedatei erforderlich!\n");
-        return 1;
+        p++;
+        if (p < end && digit_values[(unsigned char)*p] < 10)
+        {
+            return NULL;
+        }
+        *value = 0;
+        return p;
     }
-
-    return 0;
+    const char *digits = p;
+    uint64_t val = 0;
+    unsigned digit;
+    while (p < end && (digit = digit_values[(unsigned char)*p]) < 10 && p - digits < 10)
+    {
+        val = val * 10 + digit;
+        p++;
+    }
+    if (p == digits || val > UINT32_MAX || (p < end && digit_values[(unsigned char)*p] < 10))
+    {
+        return NULL;
+    }
+    *value = (uint32_t)val;
+    return p;
 }
 
-int parse_number(const char *str, uint32_t *value)
+// Schneller Weg für gültige Zeilen der Form "R","0x1234","","1","T" (Anführungszeichen je Feld
+// optional): liest die Zeile in einem Durchlauf ohne vorheriges Aufteilen. Liefert den Anfang der
+// nächsten Zeile oder NULL, wenn die Zeile anders aussieht oder ungültig ist; parse_csv_file()
+// prüft sie dann wie bisher Feld für Feld und meldet gegebenenfalls den Fehler.
+static const char *parse_line_fast(const char *p, const char *end, struct Request *r)
 {
-    // Kopieren und Entfernen von Zeilenumbrüchen und Leerzeichen am Ende
-    char clean[256];
-    strncpy(clean, str, sizeof(clean));
-    clean[sizeof(clean) - 1] = '\0';
+    bool quoted;
 
-    // Entfernen von Zeilenumbruch/Leerzeichen am Ende
-    size_t len = strlen(clean);
-    while (len > 0 && (clean[len - 1] == '\n' || clean[len - 1] == '\r' || clean[len - 1] == ' ' || clean[len - 1] == '\t'))
+    p = fast_field_start(p, end, &quoted);
+    if (p == end)
     {
-        clean[--len] = '\0';
+        return NULL;
     }
-
-    // Automatische Erkennung des Zahlensystems (Präfix 0x/0X → hexadezimal)
-    char *endptr;
-    unsigned long val = strtoul(clean, &endptr, 0);
-
-    if (endptr == clean || *endptr != '\0' || val > UINT32_MAX)
+    char type = *p++ | 0x20;
+    if (type != 'r' && type != 'w')
     {
-        return 1;
+        return NULL;
+    }
+    r->w = type == 'w';
+    if (!(p = fast_field_end(p, end, quoted, false)))
+    {
+        return NULL;
     }
 
-    *value = (uint32_t)val;
-    return 0;
-}
+    p = fast_field_start(p, end, &quoted);
+    if (!(p = fast_number(p, end, &r->addr)) || !(p = fast_field_end(p, end, quoted, false)))
+    {
+        return NULL;
+    }
 
-uint32_t *load_rom_content(const char *filename, uint32_t rom_size)
-{
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    // Ein leeres Feld ohne Anführungszeichen würde beim Aufteilen übersprungen.
+    p = fast_field_start(p, end, &quoted);
+    r->data = 0;
+    if (r->w ? !(p = fast_number(p, end, &r->data)) : !quoted)
     {
-        fprintf(stderr, "Kann ROM-Inhaltsdatei nicht öffnen: %s\n", filename);
         return NULL;
     }
-    if (rom_size % 2 != 0)
+    if (!(p = fast_field_end(p, end, quoted, false)))
     {
-        fprintf(stderr, "Fehler: ROM-Größe muss eine Zweierpotenz sein!\n");
-        fclose(file);
         return NULL;
     }
-    uint32_t max_entries = rom_size / 4;
-    uint32_t *content = (uint32_t *)calloc(max_entries, sizeof(uint32_t));
-    if (!content)
+
+    uint32_t user;
+    p = fast_field_start(p, end, &quoted);
+    if (!(p = fast_number(p, end, &user)) || user > 255 || !(p = fast_field_end(p, end, quoted, false)))
     {
-        fclose(file);
         return NULL;
     }
-    char line[256];
-    uint32_t count = 0;
-    while (fgets(line, sizeof(line), file))
+    r->user = (uint8_t)user;
+
+    p = fast_field_start(p, end, &quoted);
+    if (p == end)
     {
-        uint32_t value;
-        if (parse_number(line, &value) == 0)
-        {
-            content[count++] = value;
-        }
+        return NULL;
     }
-    if (count > max_entries)
+    char wide = *p++ | 0x20;
+    if ((wide != 't' && wide != 'f') || (wide == 'f' && r->data > 0xFF))
     {
-        fprintf(stderr, "Der Inhalt der ROM überschreitet die ROM-Größe!\n");
-        free(content);
-        fclose(file);
         return NULL;
     }
-    else if (count < max_entries)
+    r->wide = wide == 't';
+    return fast_field_end(p, end, quoted, true);
+}
+
+// Hängt r an das geometrisch wachsende Feld an. Gibt 0 bei Erfolg zurück.
+static int append_request(struct Request **requests, uint32_t *num_requests, uint32_t *capacity, const struct Request *r)
+{
+    if (*num_requests == *capacity)
     {
-        while (count != max_entries)
+        uint32_t grown_capacity = *capacity ? *capacity * 2 : 1024;
+        struct Request *grown = realloc(*requests, (size_t)grown_capacity * sizeof(struct Request));
+        if (!grown)
         {
-            content[count++] = 0;
+            fprintf(stderr, "Fehler: Nicht genügend Speicher für %u Anfragen\n", grown_capacity);
+            return 1;
         }
+        *requests = grown;
+        *capacity = grown_capacity;
     }
-    fclose(file);
-    return content;
+    (*requests)[(*num_requests)++] = *r;
+    return 0;
 }
 
-bool is_line_empty(const char *line);
+bool is_line_empty(const char *line, size_t len);
 int parse_csv_file(const char *filename, struct Request **requests, uint32_t *num_requests)
-{   
+{
     int error = 0;
-    FILE *file = fopen(filename, "r");
-    if (!file)
+    struct InputBuffer input;
+    *requests = NULL;
+    *num_requests = 0;
+    if (open_input(filename, &input) != 0)
     {
         fprintf(stderr, "Kann CSV-Datei nicht öffnen: %s\n", filename);
         return 1;
     }
-    char line[256];
-    if (!fgets(line, sizeof(line), file))
+    const char *pos = input.data;
+    const char *end = input.data + input.size;
+    if (pos == end)
     {
         fprintf(stderr, "Fehler: CSV-Datei ist leer!\n");
-        free(*requests);
-        fclose(file);
+        close_input(&input);
         return 1;
     }
-    // 去除行尾换行符
-    size_t len = strlen(line);
-    while (len > 0 && (line[len-1] == '\n' || line[len-1] == '\r')) {
-        line[--len] = '\0';
+
+    // Header ohne Zeilenumbruch vergleichen
+    const char *eol = memchr(pos, '\n', end - pos);
+    const char *line_end = eol ? eol : end;
+    size_t len = line_end - pos;
+    while (len > 0 && (pos[len - 1] == '\n' || pos[len - 1] == '\r'))
+    {
+        len--;
     }
     const char *expected_header = "\"Type\",\"Address\",\"Data\",\"User\",\"Wide\"";
-    if (strcmp(line, expected_header) != 0)
+    if (len != strlen(expected_header) || memcmp(pos, expected_header, len) != 0)
     {
         fprintf(stderr, "Fehler: Ungültiger Header! Erwartet: %s", expected_header);
-        fclose(file);
+        close_input(&input);
         return 1;
     }
+    pos = eol ? eol + 1 : end;
 
-    uint32_t line_count = 0;
-    while (fgets(line, sizeof(line), file))
-    { // Count total number of rows
-        line_count++;
-    }
-    rewind(file);
-    fgets(line, sizeof(line), file); // Skip the table head (First row)
-
-    *requests = (struct Request *)malloc(line_count * sizeof(struct Request));
-    if (!*requests)
-    {
-        fclose(file);
-        return 1;
-    }
-    *num_requests = 0;
+    // Das Feld wächst geometrisch, die Datei wird nur einmal gelesen.
+    uint32_t capacity = 0;
     uint32_t current_line = 2;
-    while (fgets(line, sizeof(line), file) && *num_requests < line_count)
+    while (pos < end)
     {
-        if (is_line_empty(line))
+        struct Request r;
+        const char *next = parse_line_fast(pos, end, &r);
+        if (next != NULL)
         {
-            fprintf(stderr, "Fehler in Zeile %u: Empty Line\n", current_line);
-            error = 1;
-            break;
+            if (append_request(requests, num_requests, &capacity, &r) != 0)
+            {
+                error = 1;
+                break;
+            }
+            pos = next;
+            current_line++;
+            continue;
         }
 
-        char *token;
-        char *rest = line;
-        char *fields[5] = {NULL};
+        // Felder wie mit strtok an ',' trennen (leere Felder ohne Anführungszeichen entfallen)
+        // und je ein Anführungszeichen am Anfang und am Ende entfernen. Zeilenende und Felder
+        // werden in einem Durchlauf gefunden.
+        const char *line = pos;
+        const char *cur = pos;
+        struct Field fields[5];
         int field_count = 0;
-
-        while ((token = strtok_r(rest, ",", &rest)) && field_count < 5)
+        while (field_count < 5)
         {
-            if (token[0] == '"')
-                token++;
-            char *end = token + strlen(token) - 1;
-            if (*end == '"')
-                *end = '\0';
-            fields[field_count++] = token;
+            while (cur < end && *cur == ',')
+                cur++;
+            if (cur == end || *cur == '\n')
+                break;
+            const char *token = cur;
+            while (cur < end && *cur != ',' && *cur != '\n')
+                cur++;
+            struct Field f = {token, (size_t)(cur - token)};
+            if ((cur == end || *cur == '\n') && f.p[f.len - 1] == '\r')
+                f.len--;
+            if (f.len > 0 && f.p[0] == '"')
+            {
+                f.p++;
+                f.len--;
+            }
+            if (f.len > 0 && f.p[f.len - 1] == '"')
+                f.len--;
+            fields[field_count++] = f;
         }
+        eol = cur < end && *cur == '\n' ? cur : memchr(cur, '\n', end - cur);
+        line_end = eol ? eol : end;
+        pos = eol ? eol + 1 : end;
 
         if (field_count != 5)
         {
-            fprintf(stderr, "Fehler in Zeile %u: 5 Parameter erwartet, aber %d erhalten\n", current_line, field_count);
+            // Eine Zeile mit fünf Feldern enthält Kommas und ist daher nie leer.
+            if (line_end > line && line_end[-1] == '\r')
+            {
+                line_end--;
+            }
+            if (is_line_empty(line, line_end - line))
+            {
+                fprintf(stderr, "Fehler in Zeile %u: Empty Line\n", current_line);
+            }
+            else
+            {
+                fprintf(stderr, "Fehler in Zeile %u: 5 Parameter erwartet, aber %d erhalten\n", current_line, field_count);
+            }
             error = 1;
             break;
         }
 
-        struct Request r;
-
-        // type (fields[0])
-
         // Type
-        if (fields[0][0] == 'W' || fields[0][0] == 'w')
+        if (fields[0].len > 0 && (fields[0].p[0] == 'W' || fields[0].p[0] == 'w'))
         {
             r.w = 1;
         }
-        else if (fields[0][0] == 'R' || fields[0][0] == 'r')
+        else if (fields[0].len > 0 && (fields[0].p[0] == 'R' || fields[0].p[0] == 'r'))
         {
             r.w = 0;
         }
         else
         {
-            fprintf(stderr, "Fehler in Zeile %u: Unbekannter Typ '%s'\n", current_line, fields[0]);
+            fprintf(stderr, "Fehler in Zeile %u: Unbekannter Typ '%.*s'\n", current_line, (int)fields[0].len, fields[0].p);
             error = 1;
             break;
         }
 
         // address (fields[1])
-        if (parse_number(fields[1], &r.addr) != 0)
+        if (parse_number_n(fields[1].p, fields[1].len, &r.addr) != 0)
         {
-            fprintf(stderr, "Fehler in Zeile %u: Ungültige Adresse '%s'\n", current_line, fields[1]);
+            fprintf(stderr, "Fehler in Zeile %u: Ungültige Adresse '%.*s'\n", current_line, (int)fields[1].len, fields[1].p);
             error = 1;
             break;
         }
@@ -287,19 +1346,19 @@ int parse_csv_file(const char *filename, struct Request **requests, uint32_t *nu
         // data (fields[2])
         if (r.w)
         {
-            if (fields[2] == NULL || strlen(fields[2]) == 0)
+            if (fields[2].len == 0)
             {
                 fprintf(stderr, "Fehler in Zeile %u: Schreibanforderung muss Daten enthalten\n", current_line);
                 error = 1;
                 break;
             }
-            if (parse_number(fields[2], &r.data) != 0)
+            if (parse_number_n(fields[2].p, fields[2].len, &r.data) != 0)
             {
-                fprintf(stderr, "Fehler in Zeile %u: Ungültige Daten '%s'\n", current_line, fields[2]);
+                fprintf(stderr, "Fehler in Zeile %u: Ungültige Daten '%.*s'\n", current_line, (int)fields[2].len, fields[2].p);
                 error = 1;
                 break;
             }
-            if (fields[4][0] == 'F' || fields[4][0] == 'f')
+            if (fields[4].len > 0 && (fields[4].p[0] == 'F' || fields[4].p[0] == 'f'))
             {
                 if (r.data > 0xFF)
                 {
@@ -311,7 +1370,7 @@ int parse_csv_file(const char *filename, struct Request **requests, uint32_t *nu
         }
         else
         {
-            if (fields[2] != NULL && strlen(fields[2]) > 0)
+            if (fields[2].len > 0)
             {
                 fprintf(stderr, "Fehler in Zeile %u: Leseanforderung darf keine Daten enthalten\n", current_line);
                 error = 1;
@@ -322,105 +1381,463 @@ int parse_csv_file(const char *filename, struct Request **requests, uint32_t *nu
 
         // user (fields[3])
         uint32_t user;
-        if (parse_number(fields[3], &user) != 0 || user > 255)
+        if (parse_number_n(fields[3].p, fields[3].len, &user) != 0 || user > 255)
         {
-            fprintf(stderr, "Fehler in Zeile %u: Ungültiger Benutzer '%s'\n", current_line, fields[3]);
+            fprintf(stderr, "Fehler in Zeile %u: Ungültiger Benutzer '%.*s'\n", current_line, (int)fields[3].len, fields[3].p);
             error = 1;
             break;
         }
         r.user = (uint8_t)user;
 
         // wide (fields[4])
-        if (fields[4][0] == 'T' || fields[4][0] == 't')
+        if (fields[4].len > 0 && (fields[4].p[0] == 'T' || fields[4].p[0] == 't'))
         {
             r.wide = 1;
         }
-        else if (fields[4][0] == 'F' || fields[4][0] == 'f')
+        else if (fields[4].len > 0 && (fields[4].p[0] == 'F' || fields[4].p[0] == 'f'))
         {
             r.wide = 0;
         }
         else
         {
-            fprintf(stderr, "Fehler in Zeile %u: Ungültiges Wide-Flag '%s'\n", current_line, fields[4]);
+            fprintf(stderr, "Fehler in Zeile %u: Ungültiges Wide-Flag '%.*s'\n", current_line, (int)fields[4].len, fields[4].p);
             error = 1;
             break;
         }
 
-        (*requests)[(*num_requests)++] = r;
+        if (append_request(requests, num_requests, &capacity, &r) != 0)
+        {
+            error = 1;
+            break;
+        }
         current_line++;
-        continue;
-
     }
 
-    if (error) {
-            free(*requests);
-    fclose(file);
-    return 1;
+    close_input(&input);
+    if (error)
+    {
+        free(*requests);
+        *requests = NULL;
+        *num_requests = 0;
+        return 1;
     }
-    fclose(file);
     return 0;
 }
 
-bool is_line_empty(const char *line)
+bool is_line_empty(const char *line, size_t len)
 {
-    while (*line)
+    for (size_t i = 0; i < len; i++)
     {
-        if (!isspace((unsigned char)*line))
+        if (!isspace((unsigned char)line[i]))
             return false;
-        line++;
     }
     return true;
 }
 
+// Führt die Simulation mit den Optionen `options` in einem Kindprozess ohne Ausgaben und ohne
+// Trace-Datei aus. So lässt sich eine Vergleichszahl ermitteln, obwohl SystemC nur eine
+// Simulation pro Prozess erlaubt. Gibt 0 bei Erfolg zurück.
+static int run_reference(simulate_fn simulate, const MemConfig *config, const struct SimOptions *options,
+                         uint32_t *rom_content, uint32_t num_requests, struct Request *requests, struct Result *result)
+{
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return 1;
+    }
+    fflush(NULL);
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return 1;
+    }
+    if (pid == 0)
+    {
+        close(fds[0]);
+        freopen("/dev/null", "w", stdout);
+        freopen("/dev/null", "w", stderr);
+        log_set_levels("off");
+        struct Result child_result = simulate(config->cycles, NULL, config->latency_rom, config->rom_size,
+                                              config->block_size, rom_content, num_requests, requests, options);
+        ssize_t written = write(fds[1], &child_result, sizeof(child_result));
+        _exit(written == (ssize_t)sizeof(child_result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t got = read(fds[0], result, sizeof(*result));
+    close(fds[0]);
+    int status;
+    waitpid(pid, &status, 0);
+    return got == (ssize_t)sizeof(*result) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1;
+}
+
+// --chunk: Erzeugt die Last stückweise und simuliert sie in einer Sitzung, sodass nie mehr als
+// ein Stapel Anfragen im Speicher liegt. Gibt 0 bei Erfolg zurück.
+static int run_streamed(const MemConfig *config, uint32_t *rom_content, struct SessionStats *totals)
+{
+    struct WorkloadSpec spec;
+    if (workload_parse(config->workload, config->rom_size, &spec) != 0)
+    {
+        return 1;
+    }
+    struct WorkloadStream *stream = workload_stream_create(&spec);
+    struct SimSession *session = sim_session_create(config->tracefile, config->latency_rom, config->rom_size,
+                                                    config->block_size, rom_content, &config->options);
+    int rc = 1;
+    if (session != NULL)
+    {
+        rc = sim_session_stream(session, workload_stream_read, stream, config->chunk);
+        sim_session_stats(session, totals);
+        sim_session_destroy(session);
+    }
+    workload_stream_destroy(stream);
+    return rc;
+}
+
 int main(int argc, char *argv[])
 {
+    double start = profile_now();
     MemConfig config;
     struct Request *requests = NULL;
     uint32_t num_requests = 0;
-    uint32_t *rom_content = NULL;
+    struct RomContent rom = {0};
 
     if (parse_arguments(argc, argv, &config) != 0)
     {
         return 1;
     }
 
-    if (config.rom_content_file != NULL)
+    simulate_fn simulate = run_simulation_ext;
+    if (config.mode == MODE_LT)
+    {
+        simulate = run_simulation_lt;
+    }
+    else if (config.mode == MODE_PIPELINED)
+    {
+        simulate = run_simulation_pipelined;
+    }
+
+    // Der Benchmark erzeugt seine Anfragen und lädt die ROM in jedem Lauf selbst.
+    if (config.bench != NULL)
+    {
+        if (config.profile_file != NULL)
+        {
+            fprintf(stderr, "Hinweis: --profile wird mit --bench ignoriert.\n");
+        }
+        struct SweepList sizes;
+        if (sweep_parse_list(config.bench_sizes != NULL ? config.bench_sizes : DEFAULT_BENCH_SIZES, 0, &sizes) != 0)
+        {
+            fprintf(stderr, "Ungültige Liste für --bench-sizes.\n");
+            return EXIT_FAILURE;
+        }
+        int rc = run_bench(&config, simulate, config.bench, &sizes);
+        sweep_free_list(&sizes);
+        return rc == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    bool sweep = config.sweep_latency_rom != NULL || config.sweep_block_size != NULL || config.sweep_rom_size != NULL;
+
+    // Die Abschnitte bis zu den Anfragen werden hier gemessen, die übrigen in der Simulation.
+    struct SimProfile *profile = NULL;
+    if (config.profile_file != NULL && !sweep)
+    {
+        profile = calloc(1, sizeof(struct SimProfile));
+        if (profile == NULL)
+        {
+            fprintf(stderr, "Fehler: Kein Speicher für das Profil.\n");
+            return EXIT_FAILURE;
+        }
+        profile_add(profile, PROFILE_ARGUMENTS, start);
+    }
+
+    // Im Sweep lädt jeder Punkt den ROM-Inhalt passend zu seiner ROM-Größe selbst.
+    start = profile_now();
+    if (config.rom_content_file != NULL && !sweep)
     {
-        rom_content = load_rom_content(config.rom_content_file, config.rom_size);
-        if (rom_content == NULL)
+        if (rom_load(config.rom_content_file, config.rom_size, config.rom_format, &rom) != 0)
         {
             fprintf(stderr, "Fehler beim Laden des ROM-Inhalts.\n");
+            free(profile);
             return EXIT_FAILURE;
         }
     }
+    profile_add(profile, PROFILE_ROM_LOAD, start);
 
-    if (parse_csv_file(config.inputfile, &requests, &num_requests) != 0)
+    // Binär-Traces werden eingeblendet und ohne Parsen übergeben
+    start = profile_now();
+    struct RequestTrace trace = {0};
+    if (config.workload != NULL && config.chunk == 0)
     {
-        fprintf(stderr, "Fehler beim Parsen der CSV-Datei.\n");
-        if (rom_content != NULL)
+        struct WorkloadSpec spec;
+        if (workload_parse(config.workload, config.rom_size, &spec) != 0 ||
+            workload_generate(&spec, &trace.requests) != 0)
+        {
+            fprintf(stderr, "Fehler beim Erzeugen der Last.\n");
+            free(profile);
+            rom_release(&rom);
+            return EXIT_FAILURE;
+        }
+        trace.num_requests = spec.count;
+    }
+    else if (config.inputfile != NULL && has_extension(config.inputfile, ".bin"))
+    {
+        // Beim Umwandeln werden alle Anfragen ohnehin gelesen und sollen nicht ungeprüft weitergegeben werden.
+        if (trace_load(config.inputfile, &trace, config.verify_trace || config.convert_file != NULL) != 0)
         {
-            free(rom_content);
+            fprintf(stderr, "Fehler beim Laden des Binär-Traces.\n");
+            free(profile);
+            rom_release(&rom);
+            return EXIT_FAILURE;
         }
+    }
+    else if (config.inputfile != NULL && parse_csv_file(config.inputfile, &trace.requests, &trace.num_requests) != 0)
+    {
+        fprintf(stderr, "Fehler beim Parsen der CSV-Datei.\n");
+        free(profile);
+        rom_release(&rom);
         return EXIT_FAILURE;
     }
+    requests = trace.requests;
+    num_requests = trace.num_requests;
+    profile_add(profile, PROFILE_REQUESTS, start);
+
+    if (config.convert_file != NULL)
+    {
+        int rc = trace_write(config.convert_file, requests, num_requests, config.convert_delta);
+        if (rc == 0)
+        {
+            fprintf(stderr, "%u Anfragen nach %s geschrieben.\n", num_requests, config.convert_file);
+        }
+        free(profile);
+        trace_release(&trace);
+        rom_release(&rom);
+        return rc == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    if (sweep)
+    {
+        if (config.stats_file != NULL)
+        {
+            fprintf(stderr, "Hinweis: --stats wird im Sweep ignoriert.\n");
+        }
+        if (config.profile_file != NULL)
+        {
+            fprintf(stderr, "Hinweis: --profile wird im Sweep ignoriert.\n");
+        }
+        struct SweepList latencies, block_sizes, rom_sizes;
+        int rc = 1;
+        if (sweep_parse_list(config.sweep_latency_rom, config.latency_rom, &latencies) == 0)
+        {
+            if (sweep_parse_list(config.sweep_block_size, config.block_size, &block_sizes) == 0)
+            {
+                bool zero_block = false;
+                for (uint32_t i = 0; i < block_sizes.count; i++)
+                {
+                    zero_block = zero_block || block_sizes.values[i] == 0;
+                }
+                if (zero_block)
+                {
+                    fprintf(stderr, "Die Blockgröße muss größer als 0 sein: %s\n", config.sweep_block_size);
+                }
+                else if (sweep_parse_list(config.sweep_rom_size, config.rom_size, &rom_sizes) == 0)
+                {
+                    rc = run_sweep(&config, simulate, &latencies, &block_sizes, &rom_sizes, config.jobs,
+                                   config.sweep_out, num_requests, requests);
+                    sweep_free_list(&rom_sizes);
+                }
+                sweep_free_list(&block_sizes);
+            }
+            sweep_free_list(&latencies);
+        }
+        trace_release(&trace);
+        return rc == 0 ? 0 : EXIT_FAILURE;
+    }
+
+    // Vergleichslauf mit Read-Modify-Write, um die Ersparnis durch Byte-Enable anzugeben
+    struct Result reference = {0};
+    bool has_reference = false;
+    // Im Split-Transaction-Modell sind 1-Byte-Schreibzugriffe immer Byte-Enable-Zugriffe, mit
+    // --chunk gibt es kein Feld der Anfragen für einen zweiten Lauf.
+    if (config.options.byte_enable && config.mode != MODE_PIPELINED && config.chunk == 0)
+    {
+        struct SimOptions legacy = config.options;
+        legacy.byte_enable = 0;
+        // Das Abbild nach --ram file: schreibt nur der eigentliche Lauf.
+        legacy.ram_file = NULL;
+        has_reference = run_reference(simulate, &config, &legacy, rom.words, num_requests, requests, &reference) == 0;
+        if (!has_reference)
+        {
+            fprintf(stderr, "Vergleichslauf ohne Byte-Enable fehlgeschlagen.\n");
+        }
+    }
+
+    // Die Histogramme haben feste Größe und werden einmal für den ganzen Lauf angelegt.
+    struct RequestStats *stats = NULL;
+    if (config.stats_file != NULL)
+    {
+        stats = calloc(1, sizeof(struct RequestStats));
+        if (stats == NULL)
+        {
+            fprintf(stderr, "Fehler: Kein Speicher für die Statistik.\n");
+            free(profile);
+            rom_release(&rom);
+            trace_release(&trace);
+            return EXIT_FAILURE;
+        }
+        config.options.stats = stats;
+    }
+    // Nach dem Vergleichslauf, damit nur der eigentliche Lauf gemessen wird
+    config.options.profile = profile;
 
-    struct Result result = run_simulation(
-        config.cycles,
-        config.tracefile,
-        config.latency_rom,
-        config.rom_size,
-        config.block_size,
-        rom_content,
-        num_requests,
-        requests);
+    struct MasterStats *master_stats = NULL;
+    if (config.options.split_users)
+    {
+        master_stats = calloc(256, sizeof(struct MasterStats));
+        if (master_stats == NULL)
+        {
+            fprintf(stderr, "Fehler: Kein Speicher für die Statistik.\n");
+            free(stats);
+            free(profile);
+            rom_release(&rom);
+            trace_release(&trace);
+            return EXIT_FAILURE;
+        }
+        config.options.master_stats = master_stats;
+    }
+
+    struct Result result;
+    // Mit --chunk können Takte und Fehler über 32 Bit hinausgehen
+    struct SessionStats totals = {0};
+    if (config.chunk > 0)
+    {
+        if (run_streamed(&config, rom.words, &totals) != 0)
+        {
+            fprintf(stderr, "Fehler beim Simulieren der Last in Stapeln.\n");
+            free(stats);
+            free(profile);
+            rom_release(&rom);
+            return EXIT_FAILURE;
+        }
+        result = totals.result;
+    }
+    else
+    {
+        result = simulate(
+            config.cycles,
+            config.tracefile,
+            config.latency_rom,
+            config.rom_size,
+            config.block_size,
+            rom.words,
+            num_requests,
+            requests,
+            &config.options);
+        totals.cycles = result.cycles;
+        totals.errors = result.errors;
+    }
+    if (result.failed)
+    {
+        // Die Ursache hat die Simulation bereits gemeldet.
+        free(master_stats);
+        free(stats);
+        free(profile);
+        rom_release(&rom);
+        trace_release(&trace);
+        return EXIT_FAILURE;
+    }
 
     printf("\n --- Simulation beendet --- \n");
-    printf("Zyklen: %u\n", result.cycles);
-    printf("Fehler: %u\n", result.errors);
+    printf("Zyklen: %llu\n", (unsigned long long)totals.cycles);
+    printf("Fehler: %llu\n", (unsigned long long)totals.errors);
+    if (has_reference)
+    {
+        printf("Zyklen ohne Byte-Enable: %u (eingespart: %lld)\n", reference.cycles,
+               (long long)reference.cycles - (long long)result.cycles);
+    }
+    if (config.options.cache_size > 0)
+    {
+        printf("Cache-Treffer: %u\n", result.cache_hits);
+        printf("Cache-Fehlzugriffe: %u\n", result.cache_misses);
+        printf("Cache-Rückschreibungen: %u\n", result.cache_writebacks);
+    }
+    if (config.options.dram)
+    {
+        printf("DRAM-Zeilentreffer: %u\n", result.dram_row_hits);
+        printf("DRAM-Zugriffe auf geschlossene Bänke: %u\n", result.dram_row_misses);
+        printf("DRAM-Zeilenkonflikte: %u\n", result.dram_row_conflicts);
+    }
+    if (config.options.rom_prefetch > 0)
+    {
+        // Genauigkeit: genutzter Anteil der vorausgelesenen Zeilen. Abdeckung: Anteil der
+        // Fehlzugriffe ohne Prefetcher (verbliebene + durch Prefetches vermiedene), die vermieden wurden.
+        uint32_t misses = result.rom_reads - result.rom_buffer_hits;
+        printf("ROM-Lesezugriffe: %u, davon aus dem Zeilenpuffer: %u\n", result.rom_reads, result.rom_buffer_hits);
+        printf("ROM-Prefetches: %u, davon genutzt: %u\n", result.rom_prefetches, result.rom_prefetches_useful);
+        printf("Prefetch-Genauigkeit: %.1f %%\n",
+               result.rom_prefetches > 0 ? 100.0 * result.rom_prefetches_useful / result.rom_prefetches : 0.0);
+        printf("Prefetch-Abdeckung: %.1f %%\n",
+               result.rom_prefetches_useful + misses > 0
+                   ? 100.0 * result.rom_prefetches_useful / (result.rom_prefetches_useful + misses)
+                   : 0.0);
+    }
+    if (config.options.store_buffer > 0)
+    {
+        printf("Schreibpuffer: %u Schreibzugriffe, davon zusammengefasst: %u\n", result.store_writes, result.store_coalesced);
+        printf("Aus dem Schreibpuffer beantwortete Lesezugriffe: %u\n", result.store_forwarded);
+        printf("Speicherzugriffe beim Leeren: %u\n", result.store_mem_writes);
+    }
 
-    if (rom_content != NULL)
-        free(rom_content);
-    if (requests != NULL)
-        free(requests);
-    return 0;
+    if (master_stats != NULL)
+    {
+        printf("\nMaster  Anfragen  Fehler  Anfragen/1000 Takte  Wartezeit (Mittel/Max)  Bedienzeit (Mittel)\n");
+        for (int u = 0; u < 256; u++)
+        {
+            const struct MasterStats *m = &master_stats[u];
+            if (m->requests == 0)
+            {
+                continue;
+            }
+            printf("%6d  %8u  %6u  %19.2f  %13.2f / %6u  %19.2f\n", u, m->requests, m->errors,
+                   m->finish_cycle > 0 ? 1000.0 * m->requests / m->finish_cycle : 0.0,
+                   (double)m->queue_cycles / m->requests, m->max_queue_cycles,
+                   (double)m->service_cycles / m->requests);
+        }
+        free(master_stats);
+    }
+
+    int rc = 0;
+    if (stats != NULL)
+    {
+        FILE *out = fopen(config.stats_file, "w");
+        if (out != NULL)
+        {
+            request_stats_write_json(out, stats);
+        }
+        if (out == NULL || fclose(out) != 0)
+        {
+            fprintf(stderr, "Kann Statistikdatei nicht schreiben: %s\n", config.stats_file);
+            rc = EXIT_FAILURE;
+        }
+        free(stats);
+    }
+    if (profile != NULL)
+    {
+        FILE *out = fopen(config.profile_file, "w");
+        if (out != NULL)
+        {
+            profile_write_json(out, profile);
+        }
+        if (out == NULL || fclose(out) != 0)
+        {
+            fprintf(stderr, "Kann Profildatei nicht schreiben: %s\n", config.profile_file);
+            rc = EXIT_FAILURE;
+        }
+        free(profile);
+    }
+
+    rom_release(&rom);
+    trace_release(&trace);
+    return rc;
 }
@@ -14,6 +14,21 @@ extern "C"
     {
         uint32_t cycles;
         uint32_t errors;
+        uint32_t cache_hits;       // nur mit Cache (SimOptions.cache_size > 0)
+        uint32_t cache_misses;
+        uint32_t cache_writebacks; // zurückgeschriebene geänderte Zeilen
+        uint32_t dram_row_hits;    // nur mit DRAM-Modell (SimOptions.dram)
+        uint32_t dram_row_misses;  // Zugriffe auf eine Bank ohne offene Zeile
+        uint32_t dram_row_conflicts;
+        uint32_t rom_reads;             // nur mit ROM-Prefetcher (SimOptions.rom_prefetch > 0)
+        uint32_t rom_buffer_hits;       // aus dem Zeilenpuffer bediente Lesezugriffe
+        uint32_t rom_prefetches;        // vorausgelesene Zeilen
+        uint32_t rom_prefetches_useful; // davon gelesen, bevor sie verdrängt wurden
+        uint32_t store_writes;          // nur mit Schreibpuffer (SimOptions.store_buffer > 0)
+        uint32_t store_coalesced;       // mit einer gepufferten Zeile zusammengefasste Schreibzugriffe
+        uint32_t store_forwarded;       // aus dem Schreibpuffer beantwortete Lesezugriffe
+        uint32_t store_mem_writes;      // Speicherzugriffe beim Leeren des Schreibpuffers
+        uint32_t failed;                // != 0: Lauf nicht durchgeführt, z.B. --ram file: nicht einblendbar
     };
 
     struct Request
@@ -25,6 +40,152 @@ extern "C"
         uint8_t wide;  // 1 = 4Bytes, 0 = 1Byte
     };
 
+    // Simulationsmodell
+    enum SimMode
+    {
+        MODE_SIGNAL = 0,   // signalgenau mit Takt und Handshake-Signalen
+        MODE_LT = 1,       // TLM-2.0 loosely-timed (b_transport mit annotierten Verzögerungen)
+        MODE_PIPELINED = 2 // signalgenau, Split-Transaction mit mehreren offenen Anfragen
+    };
+
+    // Format der ROM-Inhaltsdatei (siehe rom_loader.h)
+    enum RomFormat
+    {
+        ROM_FORMAT_AUTO = 0, // ELF am Dateianfang, sonst nach der Endung, sonst Text
+        ROM_FORMAT_TEXT = 1, // eine Zahl je Zeile
+        ROM_FORMAT_BIN = 2,  // Rohabbild ab Adresse 0
+        ROM_FORMAT_IHEX = 3, // Intel HEX
+        ROM_FORMAT_ELF = 4   // PT_LOAD-Segmente an ihrer physischen Adresse
+    };
+
+    // Ersetzungsstrategie des Caches
+    enum CacheReplacementPolicy
+    {
+        CACHE_LRU = 0,
+        CACHE_PLRU = 1,
+        CACHE_RANDOM = 2
+    };
+
+    // Auslöser für den Beginn der Aufzeichnung
+    enum TraceTrigger
+    {
+        TRACE_TRIGGER_NONE = 0,    // ab trace_start
+        TRACE_TRIGGER_REQUEST = 1, // ab der Anfrage Nummer trace_trigger_index (frühestens trace_start)
+        TRACE_TRIGGER_ADDRESS = 2  // ab der ersten Anfrage in [trace_trigger_lo, trace_trigger_hi]
+    };
+
+    // Erzeuger der Trace-Datei
+    enum TraceWriter
+    {
+        TRACE_WRITER_SYSTEMC = 0, // sc_create_vcd_trace_file, schreibt im Simulations-Thread
+        TRACE_WRITER_ASYNC = 1    // AsyncVcdWriter: Ringpuffer und Hintergrund-Thread, bei ".gz" komprimiert
+    };
+
+    // Auswahl zwischen mehreren Mastern (SimOptions.split_users)
+    enum ArbitrationPolicy
+    {
+        ARBITRATION_ROUND_ROBIN = 0,
+        ARBITRATION_PRIORITY = 1, // kleinere Benutzer-ID zuerst
+        ARBITRATION_WEIGHTED = 2  // gewichtet nach SimOptions.master_weight
+    };
+
+    // Kennzahlen eines Masters (Benutzers) bei SimOptions.split_users
+    struct MasterStats
+    {
+        uint32_t requests; // beantwortete Anfragen
+        uint32_t errors;
+        uint64_t queue_cycles; // Summe der Takte in der Warteschlange bis zur Annahme
+        uint32_t max_queue_cycles;
+        uint64_t service_cycles; // Summe der Takte von der Annahme bis ready
+        uint32_t finish_cycle;   // Takte bis einschließlich der letzten beantworteten Anfrage
+    };
+
+    // Erweiterungen gegenüber der Aufgabenstellung. Mit 0 initialisiert ergibt sich das
+    // ursprüngliche Verhalten.
+    struct SimOptions
+    {
+        uint8_t byte_enable; // 1-Byte-Schreibzugriffe mit Byte-Enable statt Read-Modify-Write
+
+        // Cache vor dem Hauptspeicher (nur im signalgenauen Modell)
+        uint32_t cache_size;        // Größe in Bytes, 0 = kein Cache
+        uint32_t cache_line;        // Zeilengröße in Bytes, 0 = CACHE_DEFAULT_LINE
+        uint32_t cache_assoc;       // Anzahl der Wege, 0 = CACHE_DEFAULT_ASSOC
+        uint8_t cache_replacement;  // enum CacheReplacementPolicy
+        uint8_t cache_write_through; // 1 = Write-Through ohne Write-Allocate, 0 = Write-Back
+
+        // Takte je Anfrage nach Art und Benutzer hierhin eintragen (siehe latency_stats.h),
+        // NULL = keine Statistik. Der Aufrufer legt die Struktur genullt an.
+        struct RequestStats *stats;
+
+        // Aufzeichnungsfenster der Trace-Datei in Takten (nur im signalgenauen Modell)
+        uint32_t trace_start;        // erster aufgezeichneter Takt
+        uint32_t trace_end;          // erster nicht mehr aufgezeichneter Takt, 0 = bis zum Ende
+        uint8_t trace_end_relative;  // 1 = trace_end zählt ab dem Beginn der Aufzeichnung
+        uint8_t trace_trigger;       // enum TraceTrigger
+        uint32_t trace_trigger_index;
+        uint32_t trace_trigger_lo;
+        uint32_t trace_trigger_hi;
+        const char *trace_signals; // kommagetrennte Signale oder Gruppen, NULL = "all"
+        uint8_t trace_writer;      // enum TraceWriter; Dateinamen auf ".gz" verwenden immer TRACE_WRITER_ASYNC
+
+        // Hauptspeicher: feste Latenz oder DRAM-Modell (siehe memory_timing.hpp)
+        uint32_t latency_mem;   // Takte je Zugriff, 0 = MEM_DEFAULT_LATENCY
+        uint8_t dram;           // 1 = Bänke mit offenen Zeilen statt fester Latenz
+        uint32_t dram_banks;    // 0 = DRAM_DEFAULT_BANKS
+        uint32_t dram_row_size; // Bytes je Zeile, 0 = DRAM_DEFAULT_ROW_SIZE
+        uint32_t dram_t_rcd;    // Takte, 0 = jeweils DRAM_DEFAULT_T_*
+        uint32_t dram_t_cas;
+        uint32_t dram_t_rp;
+
+        // Mehrere Master: Anfragen nach Benutzer auf gleichzeitige Ströme aufteilen
+        // (nur im signalgenauen Modell, siehe multi_master.hpp)
+        uint8_t split_users;
+        uint8_t arbitration;          // enum ArbitrationPolicy
+        uint32_t master_queue;        // Plätze je Warteschlange, 0 = MASTER_DEFAULT_QUEUE
+        uint8_t master_weight[256];   // Gewicht je Benutzer-ID, 0 = 1
+        struct MasterStats *master_stats; // 256 Einträge (Index = Benutzer-ID), NULL = keine
+
+        // Zeilenpuffer vor dem ROM: so viele Zeilen eines erkannten Stroms vorauslesen
+        // (siehe rom_prefetcher.hpp), 0 = kein Puffer
+        uint32_t rom_prefetch;
+
+        // Nur MODE_PIPELINED (siehe pipelined_controller.hpp)
+        uint32_t outstanding; // offene Anfragen, 0 = PIPELINE_DEFAULT_OUTSTANDING
+        uint8_t out_of_order; // 1 = Antworten, sobald sie fertig sind, 0 = in Reihenfolge der Anfragen
+
+        // Nur MODE_SIGNAL: Controller, Hauptspeicher und ROM als SC_METHOD-Zustandsautomaten statt
+        // SC_THREADs (sollen dieselben Takte liefern, weniger Kontextwechsel)
+        uint8_t fsm;
+
+        // Nur MODE_SIGNAL: Schreibpuffer im Controller (siehe store_buffer.hpp)
+        uint32_t store_buffer;      // Einträge, 0 = kein Puffer
+        uint32_t store_buffer_line; // Bytes je Eintrag, 0 = STORE_BUFFER_DEFAULT_LINE
+
+        // Inhalt des Hauptspeichers als eingeblendeter 4-GiB-Bereich statt Seitentabelle
+        // (siehe ram_store.hpp), alle Modelle
+        uint8_t ram_mapped;
+        const char *ram_file; // Abbild in dieser Datei ablegen, NULL = anonymer Speicher
+
+        // Laufzeiten der Abschnitte und Zähler des SystemC-Kerns hierhin eintragen (siehe
+        // profile.h), NULL = keine Messung. Der Aufrufer legt die Struktur genullt an.
+        struct SimProfile *profile;
+    };
+
+#define CACHE_DEFAULT_LINE 32
+#define CACHE_DEFAULT_ASSOC 4
+#define MEM_DEFAULT_LATENCY 3
+#define MASTER_DEFAULT_QUEUE 4
+#define DRAM_DEFAULT_BANKS 8
+#define DRAM_DEFAULT_ROW_SIZE 2048
+#define DRAM_DEFAULT_T_RCD 2
+#define DRAM_DEFAULT_T_CAS 2
+#define DRAM_DEFAULT_T_RP 2
+#define ROM_PREFETCH_MAX_DEPTH 16
+#define PIPELINE_DEFAULT_OUTSTANDING 8
+#define PIPELINE_MAX_OUTSTANDING 64
+#define STORE_BUFFER_DEFAULT_LINE 16
+#define STORE_BUFFER_MAX_ENTRIES 64
+
     typedef struct
     {
         uint32_t cycles;
@@ -34,6 +195,25 @@ extern "C"
         uint32_t rom_size;
         uint32_t block_size;
         char *rom_content_file; // Path to ROM-Content
+        enum RomFormat rom_format;
+        char *convert_file;     // --convert: Anfragen als Binär-Trace hierhin schreiben statt simulieren
+        uint8_t convert_delta;  // --delta: Binär-Trace mit Delta-Kodierung schreiben
+        uint8_t verify_trace;   // --verify-trace: Prüfsumme der Nutzdaten eines Binär-Traces prüfen
+
+        // Parameter-Sweep: Wertelisten (NULL = nur der obige Einzelwert), siehe sweep.h
+        char *sweep_latency_rom;
+        char *sweep_block_size;
+        char *sweep_rom_size;
+        char *sweep_out; // Ergebnistabelle (.csv oder .json), NULL = stdout
+        uint32_t jobs;   // gleichzeitige Simulationen, 0 = Anzahl der CPUs
+        char *stats_file; // --stats: Latenz-Histogramme als JSON, NULL = keine Statistik
+        char *profile_file; // --profile: Laufzeiten und Aktivität der Module als JSON, NULL = keine Messung
+        char *workload;    // --workload: synthetische Last statt Eingabedatei (siehe workload.h)
+        char *bench;       // --bench: Lasten für den Benchmark, getrennt durch ';'
+        char *bench_sizes; // --bench-sizes: Anzahlen der Anfragen je Last (Liste wie beim Sweep)
+        uint32_t chunk;    // --chunk: --workload in Stapeln dieser Größe durch eine Sitzung simulieren, 0 = aus
+        enum SimMode mode;
+        struct SimOptions options;
     } MemConfig;
 
     void print_help(const char *prog_name);
@@ -42,6 +222,9 @@ extern "C"
 
     int parse_number(const char *str, uint32_t *value);
 
+    // Wie parse_number, aber für die ersten len Zeichen von str (ohne abschließende 0)
+    int parse_number_n(const char *str, size_t len, uint32_t *value);
+
     uint32_t *load_rom_content(const char *filename, uint32_t rom_size);
 
     int parse_csv_file(const char *filename, struct Request **requests, uint32_t *num_requests);
@@ -56,6 +239,45 @@ extern "C"
         uint32_t numRequests,
         struct Request *requests);
 
+    // run_simulation mit zusätzlichen Optionen (NULL = Standardverhalten)
+    extern struct Result run_simulation_ext(
+        uint32_t cycles,
+        const char *tracefile,
+        uint32_t latencyRom,
+        uint32_t romSize,
+        uint32_t blockSize,
+        uint32_t *romContent,
+        uint32_t numRequests,
+        struct Request *requests,
+        const struct SimOptions *options);
+
+    // Gleiche Schnittstelle wie run_simulation_ext, liefert dieselben Zyklen und Fehler
+    extern struct Result run_simulation_lt(
+        uint32_t cycles,
+        const char *tracefile,
+        uint32_t latencyRom,
+        uint32_t romSize,
+        uint32_t blockSize,
+        uint32_t *romContent,
+        uint32_t numRequests,
+        struct Request *requests,
+        const struct SimOptions *options);
+
+    // Split-Transaction-Modell: gleiche Schnittstelle, Anfragen überlappen sich
+    extern struct Result run_simulation_pipelined(
+        uint32_t cycles,
+        const char *tracefile,
+        uint32_t latencyRom,
+        uint32_t romSize,
+        uint32_t blockSize,
+        uint32_t *romContent,
+        uint32_t numRequests,
+        struct Request *requests,
+        const struct SimOptions *options);
+
+    typedef struct Result (*simulate_fn)(uint32_t, const char *, uint32_t, uint32_t, uint32_t, uint32_t *, uint32_t,
+                                         struct Request *, const struct SimOptions *);
+
 #ifdef __cplusplus
 }
 #endif
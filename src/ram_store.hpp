@@ -0,0 +1,205 @@
+#ifndef RAM_STORE_HPP
+#define RAM_STORE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "log.h"
+#include "paged_memory.hpp"
+#include "rahmenprogramm.h"
+
+// Inhalt des Hauptspeichers. Standardmäßig eine PagedMemory; nach map() stattdessen ein
+// zusammenhängender Bereich von 4 GiB für den ganzen 32-Bit-Adressraum, der mit MAP_NORESERVE
+// nur reserviert wird. Der Kern legt Seiten erst beim ersten Zugriff an (nie beschriebene lesen
+// sich wie bisher als 0), Zugriffe sind dann einfache Zeigerzugriffe ohne Seitentabelle.
+// Mit einem Dateinamen wird die Datei statt anonymen Speichers eingeblendet (MAP_SHARED), nach
+// dem Lauf steht dort das Abbild des Hauptspeichers (Byte i = Adresse i, 4 GiB mit Löchern).
+class RamStore
+{
+public:
+    static const uint64_t SPACE_SIZE = UINT64_C(1) << 32;
+
+    RamStore() = default;
+
+    ~RamStore()
+    {
+        unmap();
+    }
+
+    RamStore(const RamStore &) = delete;
+    RamStore &operator=(const RamStore &) = delete;
+
+    // Blendet den Adressraum ein, path == nullptr = anonym. Vorher geschriebene Daten gehen
+    // verloren, map() gehört also vor den ersten Zugriff. Gibt false zurück, wenn das System den
+    // Bereich nicht bereitstellen kann; der Speicher bleibt dann seitenweise.
+    bool map(const char *path)
+    {
+        unmap();
+        if (sizeof(void *) < 8)
+        {
+            return false;
+        }
+        int flags = MAP_NORESERVE;
+        if (path != nullptr)
+        {
+            fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0 || ftruncate(fd, static_cast<off_t>(SPACE_SIZE)) != 0)
+            {
+                unmap();
+                return false;
+            }
+            flags |= MAP_SHARED;
+        }
+        else
+        {
+            flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+        }
+        void *p = mmap(nullptr, static_cast<size_t>(SPACE_SIZE), PROT_READ | PROT_WRITE, flags, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            unmap();
+            return false;
+        }
+        flat = static_cast<uint8_t *>(p);
+        return true;
+    }
+
+    bool mapped() const
+    {
+        return flat != nullptr;
+    }
+
+    // 4-Byte-Lesezugriff (Little Endian), am Ende des Adressraums mit Umlauf auf 0 wie PagedMemory
+    uint32_t readWord(uint32_t address) const
+    {
+        if (flat == nullptr)
+        {
+            return paged.readWord(address);
+        }
+        if (address > UINT32_MAX - 3)
+        {
+            uint32_t result = 0;
+            for (int i = 0; i < 4; i++)
+            {
+                result |= static_cast<uint32_t>(flat[static_cast<uint32_t>(address + i)]) << (i * 8);
+            }
+            return result;
+        }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        uint32_t value;
+        memcpy(&value, flat + address, 4);
+        return value;
+#else
+        const uint8_t *p = flat + address;
+        return static_cast<uint32_t>(p[0]) | static_cast<uint32_t>(p[1]) << 8 |
+               static_cast<uint32_t>(p[2]) << 16 | static_cast<uint32_t>(p[3]) << 24;
+#endif
+    }
+
+    // Schreibt nur die Bytes, deren Bit in mask gesetzt ist, nicht über 0xFFFFFFFF hinaus
+    void writeWordMasked(uint32_t address, uint32_t value, uint8_t mask)
+    {
+        if (flat == nullptr)
+        {
+            paged.writeWordMasked(address, value, mask);
+            return;
+        }
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if ((mask & 0xF) == 0xF && address <= UINT32_MAX - 3)
+        {
+            memcpy(flat + address, &value, 4);
+            return;
+        }
+#endif
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            if (mask & (1u << i))
+            {
+                flat[address + i] = (value >> (i * 8)) & 0xFF;
+            }
+            if (address + i == UINT32_MAX)
+            {
+                break;
+            }
+        }
+    }
+
+    // Belegte Seiten zu 4 KiB. Eingeblendet fragt mincore() den Kern, welche Seiten des Bereichs
+    // im Speicher liegen; gezählt werden dann auch nur gelesene Seiten und bei einer Datei solche,
+    // die noch aus einem früheren Lauf im Seitencache stehen.
+    uint32_t residentPages() const
+    {
+        if (flat == nullptr)
+        {
+            return paged.residentPages();
+        }
+        long page_size = sysconf(_SC_PAGESIZE);
+        if (page_size <= 0)
+        {
+            return 0;
+        }
+        std::vector<unsigned char> vec(static_cast<size_t>(SPACE_SIZE / page_size));
+        if (mincore(flat, static_cast<size_t>(SPACE_SIZE), vec.data()) != 0)
+        {
+            return 0;
+        }
+        uint64_t resident = 0;
+        for (unsigned char v : vec)
+        {
+            resident += v & 1;
+        }
+        return static_cast<uint32_t>(resident * page_size / PagedMemory::PAGE_SIZE);
+    }
+
+private:
+    PagedMemory paged;
+    uint8_t *flat = nullptr; // eingeblendeter Adressraum, nullptr = paged
+    int fd = -1;
+
+    void unmap()
+    {
+        if (flat != nullptr)
+        {
+            munmap(flat, static_cast<size_t>(SPACE_SIZE));
+            flat = nullptr;
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+            fd = -1;
+        }
+    }
+};
+
+// Richtet den Speicher eines Hauptspeichermoduls nach opts.ram_mapped und opts.ram_file ein.
+// Ohne Datei bleibt der Hauptspeicher seitenweise, wenn der Adressraum nicht eingeblendet werden
+// kann. Mit Datei gibt es false zurück: Das verlangte Abbild entstünde sonst nie.
+inline bool configureRamStore(RamStore &store, const struct SimOptions &opts)
+{
+    if (!opts.ram_mapped)
+    {
+        return true;
+    }
+    if (!store.map(opts.ram_file))
+    {
+        if (opts.ram_file != nullptr)
+        {
+            LOG_ERROR(LOG_MEM, "Fehler: Der Adressraum konnte nicht aus %s eingeblendet werden.", opts.ram_file);
+            return false;
+        }
+        LOG_ERROR(LOG_MEM, "Fehler: Der Adressraum konnte nicht eingeblendet werden, der Hauptspeicher bleibt seitenweise.");
+        return true;
+    }
+    if (opts.ram_file != nullptr)
+    {
+        LOG_INFO(LOG_MEM, "Hauptspeicher eingeblendet aus %s", opts.ram_file);
+    }
+    return true;
+}
+
+#endif // RAM_STORE_HPP
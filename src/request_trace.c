@@ -0,0 +1,383 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "request_trace.h"
+
+#define HEADER_SIZE 48
+#define HEADER_CHECKED_SIZE 40
+
+static bool host_is_little_endian(void)
+{
+    const uint16_t probe = 1;
+    return *(const uint8_t *)&probe == 1;
+}
+
+static void put_le(uint8_t *out, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; i++)
+    {
+        out[i] = (value >> (i * 8)) & 0xFF;
+    }
+}
+
+static uint64_t get_le(const uint8_t *in, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= (uint64_t)in[i] << (i * 8);
+    }
+    return value;
+}
+
+uint64_t trace_checksum(const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001b3ull;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ p[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+static void encode_header(uint8_t *out, uint16_t flags, uint32_t record_size, uint64_t num_requests,
+                          uint64_t payload_size, uint64_t payload_checksum)
+{
+    memcpy(out, TRACE_MAGIC, 8);
+    put_le(out + 8, TRACE_VERSION, 2);
+    put_le(out + 10, flags, 2);
+    put_le(out + 12, record_size, 4);
+    put_le(out + 16, num_requests, 8);
+    put_le(out + 24, payload_size, 8);
+    put_le(out + 32, payload_checksum, 8);
+    put_le(out + 40, trace_checksum(out, HEADER_CHECKED_SIZE), 8);
+}
+
+static void encode_record(uint8_t *out, const struct Request *r)
+{
+    put_le(out, r->addr, 4);
+    put_le(out + 4, r->data, 4);
+    out[8] = r->w;
+    out[9] = r->user;
+    out[10] = r->wide;
+    out[11] = 0;
+}
+
+static size_t put_varint(uint8_t *out, uint32_t value)
+{
+    size_t n = 0;
+    while (value >= 0x80)
+    {
+        out[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (uint8_t)value;
+    return n;
+}
+
+// Gibt die Anzahl gelesener Bytes zurück, 0 bei abgeschnittenen oder zu langen Werten.
+static size_t get_varint(const uint8_t *in, const uint8_t *end, uint32_t *value)
+{
+    uint64_t result = 0;
+    size_t n = 0;
+    while (in + n < end && n < 5)
+    {
+        uint8_t byte = in[n];
+        result |= (uint64_t)(byte & 0x7F) << (7 * n);
+        n++;
+        if (!(byte & 0x80))
+        {
+            if (result > UINT32_MAX)
+            {
+                return 0;
+            }
+            *value = (uint32_t)result;
+            return n;
+        }
+    }
+    return 0;
+}
+
+int trace_write(const char *filename, const struct Request *requests, uint32_t num_requests, int delta)
+{
+    FILE *file = fopen(filename, "wb");
+    if (!file)
+    {
+        fprintf(stderr, "Kann Trace-Datei nicht anlegen: %s\n", filename);
+        return 1;
+    }
+
+    // Platz für den Header, der am Ende mit Größe und Prüfsumme geschrieben wird
+    uint8_t header[HEADER_SIZE] = {0};
+    fwrite(header, 1, HEADER_SIZE, file);
+
+    // Die Nutzdaten werden blockweise kodiert; die Prüfsumme läuft über 8-Byte-Wörter, daher
+    // bleibt ein Rest von weniger als 8 Bytes jeweils für den nächsten Block im Puffer.
+    enum
+    {
+        CHUNK = 1 << 16
+    };
+    uint8_t *buffer = malloc(CHUNK + 16);
+    if (!buffer)
+    {
+        fclose(file);
+        return 1;
+    }
+    uint64_t hash = 0xcbf29ce484222325ull;
+    uint64_t payload_size = 0;
+    size_t fill = 0;
+    uint32_t prev_addr = 0;
+    uint8_t prev_user = 0;
+    int error = 0;
+
+    for (uint32_t i = 0; i <= num_requests && !error; i++)
+    {
+        if (i < num_requests)
+        {
+            const struct Request *r = &requests[i];
+            if (!delta)
+            {
+                encode_record(buffer + fill, r);
+                fill += TRACE_RECORD_SIZE;
+            }
+            else
+            {
+                uint32_t diff = r->addr - prev_addr;
+                uint32_t zigzag = (diff << 1) ^ (uint32_t)((int32_t)diff >> 31);
+                bool new_user = i == 0 || r->user != prev_user;
+                buffer[fill++] = (r->w ? 1 : 0) | (r->wide ? 2 : 0) | (new_user ? 4 : 0);
+                fill += put_varint(buffer + fill, zigzag);
+                if (new_user)
+                {
+                    buffer[fill++] = r->user;
+                }
+                if (r->w)
+                {
+                    fill += put_varint(buffer + fill, r->data);
+                }
+                prev_addr = r->addr;
+                prev_user = r->user;
+            }
+            if (fill < CHUNK)
+            {
+                continue;
+            }
+        }
+
+        // Vollständige 8-Byte-Wörter ausgeben; am Ende auch den Rest
+        size_t out = i < num_requests ? fill & ~(size_t)7 : fill;
+        for (size_t k = 0; k + 8 <= out; k += 8)
+        {
+            uint64_t word;
+            memcpy(&word, buffer + k, sizeof(word));
+            hash = (hash ^ word) * 0x100000001b3ull;
+        }
+        for (size_t k = out & ~(size_t)7; k < out; k++)
+        {
+            hash = (hash ^ buffer[k]) * 0x100000001b3ull;
+        }
+        if (fwrite(buffer, 1, out, file) != out)
+        {
+            error = 1;
+        }
+        payload_size += out;
+        memmove(buffer, buffer + out, fill - out);
+        fill -= out;
+    }
+    free(buffer);
+
+    encode_header(header, delta ? TRACE_FLAG_DELTA : 0, delta ? 0 : TRACE_RECORD_SIZE, num_requests, payload_size, hash);
+    if (error || fseek(file, 0, SEEK_SET) != 0 || fwrite(header, 1, HEADER_SIZE, file) != HEADER_SIZE)
+    {
+        error = 1;
+    }
+    if (fclose(file) != 0 || error)
+    {
+        fprintf(stderr, "Fehler beim Schreiben der Trace-Datei: %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+static int decode_delta(const uint8_t *payload, size_t size, struct Request *requests, uint32_t num_requests)
+{
+    const uint8_t *p = payload;
+    const uint8_t *end = payload + size;
+    uint32_t addr = 0;
+    uint8_t user = 0;
+    for (uint32_t i = 0; i < num_requests; i++)
+    {
+        if (p >= end)
+        {
+            return 1;
+        }
+        uint8_t flags = *p++;
+        uint32_t zigzag;
+        size_t n = get_varint(p, end, &zigzag);
+        if (n == 0 || flags > 7)
+        {
+            return 1;
+        }
+        p += n;
+        addr += (zigzag >> 1) ^ (0u - (zigzag & 1));
+        if (flags & 4)
+        {
+            if (p >= end)
+            {
+                return 1;
+            }
+            user = *p++;
+        }
+        struct Request *r = &requests[i];
+        r->addr = addr;
+        r->w = flags & 1;
+        r->wide = (flags >> 1) & 1;
+        r->user = user;
+        r->data = 0;
+        if (r->w)
+        {
+            n = get_varint(p, end, &r->data);
+            if (n == 0)
+            {
+                return 1;
+            }
+            p += n;
+        }
+    }
+    return p == end ? 0 : 1;
+}
+
+int trace_load(const char *filename, struct RequestTrace *trace, int verify)
+{
+    memset(trace, 0, sizeof(*trace));
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Kann Trace-Datei nicht öffnen: %s\n", filename);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < HEADER_SIZE)
+    {
+        fprintf(stderr, "Fehler: %s ist keine Trace-Datei.\n", filename);
+        close(fd);
+        return 1;
+    }
+    size_t size = (size_t)st.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "Kann Trace-Datei nicht einblenden: %s\n", filename);
+        return 1;
+    }
+    trace->mapping = mapping;
+    trace->mapping_size = size;
+
+    const uint8_t *header = mapping;
+    uint16_t version = (uint16_t)get_le(header + 8, 2);
+    uint16_t flags = (uint16_t)get_le(header + 10, 2);
+    uint32_t record_size = (uint32_t)get_le(header + 12, 4);
+    uint64_t num_requests = get_le(header + 16, 8);
+    uint64_t payload_size = get_le(header + 24, 8);
+    const uint8_t *payload = header + HEADER_SIZE;
+
+    if (memcmp(header, TRACE_MAGIC, 8) != 0)
+    {
+        fprintf(stderr, "Fehler: %s ist keine Trace-Datei.\n", filename);
+        trace_release(trace);
+        return 1;
+    }
+    if (version != TRACE_VERSION || (flags & ~TRACE_FLAG_DELTA) != 0)
+    {
+        fprintf(stderr, "Fehler: Nicht unterstützte Trace-Version %u (Flags 0x%x).\n", version, flags);
+        trace_release(trace);
+        return 1;
+    }
+    if (get_le(header + 40, 8) != trace_checksum(header, HEADER_CHECKED_SIZE) ||
+        payload_size != size - HEADER_SIZE || num_requests > UINT32_MAX ||
+        (!(flags & TRACE_FLAG_DELTA) && (record_size != TRACE_RECORD_SIZE || payload_size != num_requests * TRACE_RECORD_SIZE)))
+    {
+        fprintf(stderr, "Fehler: Header der Trace-Datei %s ist beschädigt.\n", filename);
+        trace_release(trace);
+        return 1;
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    bool direct = !(flags & TRACE_FLAG_DELTA) && host_is_little_endian() && sizeof(struct Request) == TRACE_RECORD_SIZE;
+    // Direkt eingeblendete Einträge werden nur auf Wunsch gelesen, um alle Seiten anzufassen.
+    if ((verify || !direct) && get_le(header + 32, 8) != trace_checksum(payload, payload_size))
+    {
+        fprintf(stderr, "Fehler: Prüfsumme der Trace-Datei %s stimmt nicht.\n", filename);
+        trace_release(trace);
+        return 1;
+    }
+    trace->num_requests = (uint32_t)num_requests;
+
+    if (direct)
+    {
+        // Das Layout stimmt mit struct Request überein: keine Kopie, kein Dekodieren.
+        trace->requests = (struct Request *)payload;
+        return 0;
+    }
+
+    struct Request *requests = malloc((size_t)num_requests * sizeof(struct Request) + 1);
+    if (!requests)
+    {
+        trace_release(trace);
+        return 1;
+    }
+    int error = 0;
+    if (flags & TRACE_FLAG_DELTA)
+    {
+        error = decode_delta(payload, payload_size, requests, trace->num_requests);
+    }
+    else
+    {
+        for (uint32_t i = 0; i < trace->num_requests; i++)
+        {
+            const uint8_t *rec = payload + (size_t)i * TRACE_RECORD_SIZE;
+            requests[i].addr = (uint32_t)get_le(rec, 4);
+            requests[i].data = (uint32_t)get_le(rec + 4, 4);
+            requests[i].w = rec[8];
+            requests[i].user = rec[9];
+            requests[i].wide = rec[10];
+        }
+    }
+    munmap(trace->mapping, trace->mapping_size);
+    trace->mapping = NULL;
+    trace->mapping_size = 0;
+    trace->requests = requests;
+    if (error)
+    {
+        fprintf(stderr, "Fehler: Nutzdaten der Trace-Datei %s sind beschädigt.\n", filename);
+        trace_release(trace);
+        return 1;
+    }
+    return 0;
+}
+
+void trace_release(struct RequestTrace *trace)
+{
+    if (trace->mapping != NULL)
+    {
+        munmap(trace->mapping, trace->mapping_size);
+    }
+    else
+    {
+        free(trace->requests);
+    }
+    memset(trace, 0, sizeof(*trace));
+}
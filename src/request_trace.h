@@ -0,0 +1,68 @@
+#ifndef REQUEST_TRACE_H
+#define REQUEST_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Binäres Anfrageformat als Ersatz für große CSV-Dateien. Alle Zahlen sind Little Endian.
+//
+//  Header (48 Bytes, struct TraceHeader), danach payload_size Bytes Nutzdaten:
+//   - ohne TRACE_FLAG_DELTA: num_requests Einträge im Layout von struct Request
+//     (addr, data, w, user, wide, 1 Byte Füllung = 0). Die Datei wird eingeblendet und das
+//     Feld ohne Kopie an die Simulation übergeben.
+//   - mit TRACE_FLAG_DELTA: je Anfrage ein Flag-Byte (Bit 0 = w, Bit 1 = wide, Bit 2 = neuer
+//     Benutzer folgt), die Adressdifferenz zur Vorgängeranfrage als ZigZag-Varint, bei
+//     gesetztem Bit 2 ein Byte user und bei Schreibzugriffen data als Varint. Wird beim Laden
+//     einmal dekodiert.
+#define TRACE_MAGIC "GRATRACE"
+#define TRACE_VERSION 1
+#define TRACE_FLAG_DELTA 0x1
+#define TRACE_RECORD_SIZE 12
+
+    struct TraceHeader
+    {
+        char magic[8];
+        uint16_t version;
+        uint16_t flags;
+        uint32_t record_size;      // TRACE_RECORD_SIZE, bei Delta-Kodierung 0
+        uint64_t num_requests;
+        uint64_t payload_size;
+        uint64_t payload_checksum; // trace_checksum() über die Nutzdaten
+        uint64_t header_checksum;  // trace_checksum() über die ersten 40 Bytes des Headers
+    };
+
+    // Geladene Anfragen. Bei eingeblendeten Dateien zeigt requests in die Einblendung.
+    struct RequestTrace
+    {
+        struct Request *requests;
+        uint32_t num_requests;
+        void *mapping;
+        size_t mapping_size;
+    };
+
+    // Prüfsumme für Header und Nutzdaten (64-Bit-FNV-1a über 8-Byte-Wörter)
+    uint64_t trace_checksum(const void *data, size_t size);
+
+    // Schreibt die Anfragen im Binärformat, delta != 0 wählt die Delta-Kodierung.
+    // Gibt 0 bei Erfolg zurück.
+    int trace_write(const char *filename, const struct Request *requests, uint32_t num_requests, int delta);
+
+    // Lädt eine Binärdatei und prüft den Header samt Prüfsumme. Die Prüfsumme der Nutzdaten
+    // wird nur mit verify != 0 geprüft oder wenn die Nutzdaten ohnehin dekodiert werden; sonst
+    // bleibt die Einblendung unberührt, bis die Simulation die Anfragen liest. Gibt 0 bei Erfolg
+    // zurück; das Ergebnis muss mit trace_release() freigegeben werden.
+    int trace_load(const char *filename, struct RequestTrace *trace, int verify);
+
+    void trace_release(struct RequestTrace *trace);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REQUEST_TRACE_H
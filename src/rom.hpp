@@ -1,24 +1,40 @@
 #include <systemc>
-#include <map>
+
+#include "edge_timer.hpp"
+#include "log.h"
+#include "rom_image.hpp"
+#include "rom_prefetcher.hpp"
+#include "sim_profile.hpp"
 using namespace sc_core;
 
 #ifndef ROM_H
 #define ROM_H
 
-SC_MODULE(ROM)
+SC_MODULE(ROM), public ActivityCounter
 {
 
     sc_in<bool> clk, wide, read_en{"ROM_enable"};
     sc_in<uint32_t> addr;
     sc_out<bool> ready, error;
     sc_out<uint32_t> data;
-    std::map<uint32_t, uint8_t> memory;
+    // ROM-Inhalt als zusammenhängender Byte-Puffer
+    RomImage memory;
     uint32_t latency;
+    // Zeilenpuffer mit Prefetcher, mit prefetch_depth = 0 abgeschaltet
+    RomPrefetcher prefetch;
 
     SC_HAS_PROCESS(ROM);
+    // Jede Rückkehr aus wait() zählt als Aktivierung (siehe sim_profile.hpp)
+    PROFILED_WAIT
 
-    ROM(sc_module_name name, uint32_t size, uint32_t *rom_content, uint32_t latency_clk)
-        : sc_module(name), ready("rom_ready"), data("rom_data_out")
+    // Ist take_ownership gesetzt, übernimmt das ROM den mit malloc/calloc angelegten Puffer
+    // rom_content und gibt ihn selbst frei; sonst muss er die Lebensdauer des ROMs überdauern.
+    // Mit fsm läuft das ROM als SC_METHOD-Zustandsautomat (step()) statt als SC_THREAD (read()),
+    // mit gleichem Verhalten Takt für Takt.
+    ROM(sc_module_name name, uint32_t size, uint32_t *rom_content, uint32_t latency_clk, bool take_ownership = false,
+        uint32_t prefetch_depth = 0, bool fsm = false)
+        : sc_module(name), ready("rom_ready"), data("rom_data_out"), memory(size, rom_content, take_ownership),
+          prefetch(prefetch_depth, memory.size(), latency_clk > 0 ? latency_clk : 3), timer(clk)
     {
         if (latency_clk > 0)
         {
@@ -28,24 +44,21 @@ SC_MODULE(ROM)
         {
             latency = 3;
         }
-        uint32_t i = 0; // byte index in memory
-        // Korpieren die Inhalte auf memory
-        while (i < size)
+
+        if (fsm)
         {
-            uint32_t word = rom_content[0];
-            for (int k = 0; k < 4; ++k)
-            {
-                memory[i++] = (word >> (k * 8)) & 0xFF;
-            }
-            rom_content++;
-            printf("ROM writing value: 0x%08x on Address 0x%08x. \n", word, i - 4);
+            SC_METHOD(step);
+            sensitive << clk.pos();
+            dont_initialize();
+        }
+        else
+        {
+            SC_THREAD(read);
+            sensitive << clk.pos();
         }
-
-        SC_THREAD(read);
-        sensitive << clk.pos();
     }
 
-    int size()
+    uint32_t size()
     {
         return memory.size();
     }
@@ -60,8 +73,13 @@ SC_MODULE(ROM)
                 ready.write(false);
                 error.write(false);
 
-                // latency Simulation
-                for (int i = 0; i < latency; i++)
+                // latency Simulation, mit Prefetcher nur einen Takt bei einem Treffer im Zeilenpuffer
+                uint32_t cycles = latency;
+                if (prefetch.enabled())
+                {
+                    cycles = prefetch.access(addr.read(), currentCycle());
+                }
+                for (uint32_t i = 0; i < cycles; i++)
                 {
                     wait();
                 }
@@ -69,10 +87,10 @@ SC_MODULE(ROM)
                 uint32_t addresse = addr.read();
                 if (!wide.read())
                 {
-                    if (memory.count(addresse))
+                    if (addresse < memory.size())
                     {
                         data.write(static_cast<uint32_t>(memory[addresse]));
-                        printf("ROM hat 1B-Wert gefunden: 0x%08x an Adresse 0x%08x.\n", static_cast<uint32_t>(memory[addresse]), addresse);
+                        LOG_DEBUG(LOG_ROM, "ROM hat 1B-Wert gefunden: 0x%08x an Adresse 0x%08x.", static_cast<uint32_t>(memory[addresse]), addresse);
                         ready.write(true);
                     }
                     else
@@ -96,7 +114,7 @@ SC_MODULE(ROM)
                     for (int i = 0; i < 4; ++i)
                     {
                         uint32_t curr_addr = addresse + i;
-                        if (memory.count(curr_addr))
+                        if (curr_addr < memory.size())
                         {
                             result |= static_cast<uint32_t>(memory[curr_addr]) << (8 * i);
                         }
@@ -109,21 +127,156 @@ SC_MODULE(ROM)
                         }
                     }
                     data.write(result);
-                    printf("ROM hat 4B-Wert gefunden: 0x%08x an Adresse 0x%08x.\n", result, addresse);
+                    LOG_DEBUG(LOG_ROM, "ROM hat 4B-Wert gefunden: 0x%08x an Adresse 0x%08x.", result, addresse);
                     ready.write(true);
                 }
             }
         }
     }
 
-    bool write(uint32_t address, uint8_t data)
+    // Zustandsautomat mit demselben Ablauf wie read(). Wartet das ROM nicht auf die Latenz und
+    // liegt kein read_en an, wird es erst bei einer Änderung von read_en wieder aktiviert.
+    void step()
+    {
+        ActivityScope scope(*this);
+        if (timer.waiting())
+        {
+            return;
+        }
+        switch (state)
+        {
+        case ROM_IDLE:
+            // Nur wenn sich read_en zugleich mit der Flanke geändert hat, hätte read() den neuen
+            // Wert schon an dieser Flanke gesehen; sonst erst an der nächsten.
+            if (!clk.posedge())
+            {
+                state = ROM_SAMPLE;
+                next_trigger(clk.posedge_event());
+                return;
+            }
+            // fall through
+        case ROM_SAMPLE:
+            if (read_en.read())
+            {
+                uint32_t cycles = begin();
+                if (cycles > 0)
+                {
+                    state = ROM_LATENCY;
+                    timer.start(cycles);
+                    return;
+                }
+                deliver();
+            }
+            break;
+        case ROM_LATENCY:
+            deliver();
+            break;
+        }
+        idle();
+    }
+
+private:
+    enum State
+    {
+        ROM_IDLE,    // wartet auf eine Änderung von read_en
+        ROM_SAMPLE,  // prüft read_en an der nächsten Flanke
+        ROM_LATENCY  // Latenz läuft, danach Daten ausgeben
+    };
+    State state = ROM_SAMPLE;
+    EdgeTimer timer;
+    sc_time period = SC_ZERO_TIME;
+
+    // Beginn eines Lesezugriffs wie in read(), gibt die Latenz in Takten zurück (für step())
+    uint32_t begin()
+    {
+        ready.write(false);
+        error.write(false);
+
+        // latency Simulation, mit Prefetcher nur einen Takt bei einem Treffer im Zeilenpuffer
+        uint32_t cycles = latency;
+        if (prefetch.enabled())
+        {
+            cycles = prefetch.access(addr.read(), currentCycle());
+        }
+        return cycles;
+    }
+
+    // Nach der Latenz: Daten an der aktuellen Adresse ausgeben wie in read() (für step())
+    void deliver()
+    {
+        uint32_t addresse = addr.read();
+        if (!wide.read())
+        {
+            if (addresse < memory.size())
+            {
+                data.write(static_cast<uint32_t>(memory[addresse]));
+                LOG_DEBUG(LOG_ROM, "ROM hat 1B-Wert gefunden: 0x%08x an Adresse 0x%08x.", static_cast<uint32_t>(memory[addresse]), addresse);
+                ready.write(true);
+            }
+            else
+            {
+                // Dieser Fall sollte nicht auftreten: Der Memory-Controller sollte die Adresse an den Hauptspeicher weiterleiten.
+                SC_REPORT_WARNING("ROM", "Lesezugriff auf nicht zugewiesene Adresse (Byte)");
+                data.write(0xFF);
+                ready.write(true);
+            }
+        }
+        else
+        {
+            if (addresse % 4 != 0)
+            {
+                data.write(0x00);
+                error.write(true);
+                ready.write(true);
+                return;
+            }
+            uint32_t result = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                uint32_t curr_addr = addresse + i;
+                if (curr_addr < memory.size())
+                {
+                    result |= static_cast<uint32_t>(memory[curr_addr]) << (8 * i);
+                }
+                else
+                {
+                    // Zugriff auf eine Adresse außerhalb des ROM-Bereichs
+                    // Dieser Fall sollte nicht auftreten – die Alignment-Prüfung sollte ihn abfangen.
+                    SC_REPORT_WARNING("ROM", "Lesezugriff auf nicht zugewiesene Adresse (Byte)");
+                    result |= 0xFF << (8 * i);
+                }
+            }
+            data.write(result);
+            LOG_DEBUG(LOG_ROM, "ROM hat 4B-Wert gefunden: 0x%08x an Adresse 0x%08x.", result, addresse);
+            ready.write(true);
+        }
+    }
+
+    // Entspricht dem wait() am Anfang der Schleife in read(): Liegt read_en an, wird es an der
+    // nächsten Flanke geprüft, sonst erst nach einer Änderung.
+    void idle()
+    {
+        if (read_en.read())
+        {
+            state = ROM_SAMPLE;
+            next_trigger(clk.posedge_event());
+        }
+        else
+        {
+            state = ROM_IDLE;
+            next_trigger(read_en.value_changed_event());
+        }
+    }
+
+    // Takt seit Simulationsbeginn, für den Prefetcher
+    uint64_t currentCycle()
     {
-        if (memory.count(address))
+        if (period == SC_ZERO_TIME)
         {
-            memory[address] = data;
-            return true;
+            const sc_clock *clock = dynamic_cast<const sc_clock *>(clk.get_interface());
+            period = clock != nullptr ? clock->period() : sc_time(10, SC_NS);
         }
-        return false;
+        return static_cast<uint64_t>(sc_time_stamp() / period);
     }
 };
 
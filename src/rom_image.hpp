@@ -0,0 +1,79 @@
+#ifndef ROM_IMAGE_HPP
+#define ROM_IMAGE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+// Zusammenhängender Byte-Puffer des ROM-Inhalts (Little Endian). Zeigt auf Little-Endian-Hosts
+// direkt auf rom_content des Aufrufers, sonst auf eine umsortierte Kopie.
+// Wird vom signalgenauen ROM und vom LT-Modell gemeinsam verwendet. Nur lesbar: rom_loader.c
+// schützt den geladenen Inhalt mit PROT_READ.
+class RomImage
+{
+public:
+    // rom_content muss (size + 3) / 4 Wörter enthalten, auch das unvollständige letzte Wort.
+    // Ist take_ownership gesetzt, wird der mit malloc/calloc angelegte Puffer rom_content
+    // übernommen und freigegeben; sonst muss er die Lebensdauer des Abbilds überdauern.
+    RomImage(uint32_t size, uint32_t *rom_content, bool take_ownership)
+        : owned_content(nullptr)
+    {
+        // Wie bisher wird der Inhalt wortweise übernommen, die Größe also auf 4 Byte aufgerundet.
+        memory_size = (size + 3) & ~3u;
+
+        const uint16_t endian_probe = 1;
+        bool little_endian = *reinterpret_cast<const uint8_t *>(&endian_probe) == 1;
+        if (little_endian)
+        {
+            // Das Wortfeld hat auf Little-Endian-Hosts bereits das Byte-Layout des ROMs.
+            memory = reinterpret_cast<const uint8_t *>(rom_content);
+            if (take_ownership)
+            {
+                owned_content = rom_content;
+            }
+        }
+        else
+        {
+            copy.resize(memory_size);
+            for (uint32_t i = 0; i < memory_size; i += 4)
+            {
+                uint32_t word = rom_content[i / 4];
+                for (int k = 0; k < 4; ++k)
+                {
+                    copy[i + k] = (word >> (k * 8)) & 0xFF;
+                }
+            }
+            memory = copy.data();
+            if (take_ownership)
+            {
+                free(rom_content);
+            }
+        }
+    }
+
+    ~RomImage()
+    {
+        free(owned_content);
+    }
+
+    RomImage(const RomImage &) = delete;
+    RomImage &operator=(const RomImage &) = delete;
+
+    uint32_t size() const
+    {
+        return memory_size;
+    }
+
+    uint8_t operator[](uint32_t address) const
+    {
+        return memory[address];
+    }
+
+private:
+    const uint8_t *memory;
+    uint32_t memory_size;
+    std::vector<uint8_t> copy;
+    uint32_t *owned_content;
+};
+
+#endif // ROM_IMAGE_HPP
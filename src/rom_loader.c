@@ -0,0 +1,445 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "rom_loader.h"
+
+#define ELF_PT_LOAD 1
+
+static bool host_is_little_endian(void)
+{
+    const uint16_t probe = 1;
+    return *(const uint8_t *)&probe == 1;
+}
+
+static uint64_t get_le(const uint8_t *in, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value |= (uint64_t)in[i] << (i * 8);
+    }
+    return value;
+}
+
+static bool has_extension(const char *filename, const char *extension)
+{
+    size_t len = strlen(filename);
+    size_t ext_len = strlen(extension);
+    return len >= ext_len && strcmp(filename + len - ext_len, extension) == 0;
+}
+
+static size_t page_size(void)
+{
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// Eine schreibgeschützt eingeblendete Eingabedatei
+struct RomFile
+{
+    int fd;
+    const uint8_t *data;
+    size_t size;
+};
+
+static int open_file(const char *filename, struct RomFile *file)
+{
+    memset(file, 0, sizeof(*file));
+    file->fd = open(filename, O_RDONLY);
+    if (file->fd < 0)
+    {
+        fprintf(stderr, "Kann ROM-Inhaltsdatei nicht öffnen: %s\n", filename);
+        return 1;
+    }
+    struct stat st;
+    if (fstat(file->fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        fprintf(stderr, "Fehler: %s ist keine reguläre Datei.\n", filename);
+        close(file->fd);
+        return 1;
+    }
+    file->size = (size_t)st.st_size;
+    if (file->size > 0)
+    {
+        void *mapping = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, file->fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            fprintf(stderr, "Kann ROM-Inhaltsdatei nicht einblenden: %s\n", filename);
+            close(file->fd);
+            return 1;
+        }
+        file->data = mapping;
+    }
+    return 0;
+}
+
+static void close_file(struct RomFile *file)
+{
+    if (file->data != NULL)
+    {
+        munmap((void *)file->data, file->size);
+    }
+    close(file->fd);
+    memset(file, 0, sizeof(*file));
+}
+
+// Reserviert einen genullten, vorerst beschreibbaren Bereich aus ganzen Seiten für den ROM-Inhalt.
+static int reserve(struct RomContent *rom, uint32_t rom_size)
+{
+    size_t page = page_size();
+    size_t bytes = ((size_t)rom_size + 3) & ~(size_t)3;
+    size_t size = (bytes > 0 ? bytes : 4) + page - 1;
+    size -= size % page;
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        fprintf(stderr, "Fehler: Kein Speicher für den ROM-Inhalt.\n");
+        return 1;
+    }
+    rom->mapping = mapping;
+    rom->mapping_size = size;
+    rom->words = mapping;
+    return 0;
+}
+
+// Legt die Dateibytes [offset, offset + length) an die ROM-Adresse address. Seiten, die ganz
+// darin liegen, werden direkt aus der Datei eingeblendet, wenn Versatz und Adresse innerhalb der
+// Seite übereinstimmen; Anfang und Ende werden kopiert.
+static int place(struct RomContent *rom, const struct RomFile *file, uint64_t offset, uint32_t address, uint32_t length)
+{
+    uint8_t *base = rom->mapping;
+    size_t page = page_size();
+    size_t first = address;
+    size_t end = first + length;
+    size_t mapped_from = end;
+    size_t mapped_to = end;
+
+    if (offset % page == first % page)
+    {
+        size_t from = (first + page - 1) / page * page;
+        size_t to = end / page * page;
+        if (to > from)
+        {
+            void *mapping = mmap(base + from, to - from, PROT_READ, MAP_PRIVATE | MAP_FIXED, file->fd,
+                                 (off_t)(offset + (from - first)));
+            if (mapping == MAP_FAILED)
+            {
+                return 1;
+            }
+            mapped_from = from;
+            mapped_to = to;
+        }
+    }
+    memcpy(base + first, file->data + offset, mapped_from - first);
+    memcpy(base + mapped_to, file->data + offset + (mapped_to - first), end - mapped_to);
+    return 0;
+}
+
+static int load_binary(const char *filename, const struct RomFile *file, uint32_t rom_size, struct RomContent *rom)
+{
+    if (file->size > rom_size)
+    {
+        fprintf(stderr, "Der Inhalt der ROM überschreitet die ROM-Größe!\n");
+        return 1;
+    }
+    if (file->size > 0 && place(rom, file, 0, 0, (uint32_t)file->size) != 0)
+    {
+        fprintf(stderr, "Kann ROM-Inhaltsdatei nicht einblenden: %s\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+static int load_elf(const char *filename, const struct RomFile *file, uint32_t rom_size, struct RomContent *rom)
+{
+    const uint8_t *elf = file->data;
+    if (file->size < 52 || memcmp(elf, "\x7f" "ELF", 4) != 0 || (elf[4] != 1 && elf[4] != 2) || elf[5] != 1)
+    {
+        fprintf(stderr, "Fehler: %s ist keine Little-Endian-ELF-Datei.\n", filename);
+        return 1;
+    }
+    bool is64 = elf[4] == 2;
+    if (is64 && file->size < 64)
+    {
+        fprintf(stderr, "Fehler: ELF-Header von %s ist unvollständig.\n", filename);
+        return 1;
+    }
+    uint64_t phoff = is64 ? get_le(elf + 32, 8) : get_le(elf + 28, 4);
+    uint64_t phentsize = get_le(elf + (is64 ? 54 : 42), 2);
+    uint64_t phnum = get_le(elf + (is64 ? 56 : 44), 2);
+    if (phentsize < (is64 ? 56u : 32u) || phoff > file->size || phnum * phentsize > file->size - phoff)
+    {
+        fprintf(stderr, "Fehler: Programmkopf von %s ist beschädigt.\n", filename);
+        return 1;
+    }
+
+    uint32_t segments = 0;
+    for (uint64_t i = 0; i < phnum; i++)
+    {
+        const uint8_t *ph = elf + phoff + i * phentsize;
+        if (get_le(ph, 4) != ELF_PT_LOAD)
+        {
+            continue;
+        }
+        uint64_t offset = get_le(ph + (is64 ? 8 : 4), is64 ? 8 : 4);
+        uint64_t address = get_le(ph + (is64 ? 24 : 12), is64 ? 8 : 4);
+        uint64_t filesz = get_le(ph + (is64 ? 32 : 16), is64 ? 8 : 4);
+        uint64_t memsz = get_le(ph + (is64 ? 40 : 20), is64 ? 8 : 4);
+        if (filesz > memsz || offset > file->size || filesz > file->size - offset)
+        {
+            fprintf(stderr, "Fehler: Segment %llu von %s ist beschädigt.\n", (unsigned long long)i, filename);
+            return 1;
+        }
+        if (address > rom_size || memsz > rom_size - address)
+        {
+            fprintf(stderr, "Fehler: Segment %llu von %s (0x%llx-0x%llx) liegt nicht im ROM.\n", (unsigned long long)i,
+                    filename, (unsigned long long)address, (unsigned long long)(address + memsz));
+            return 1;
+        }
+        // Überlappende Segmente würden bereits eingeblendete Seiten überschreiben.
+        for (uint64_t k = 0; k < i; k++)
+        {
+            const uint8_t *other = elf + phoff + k * phentsize;
+            uint64_t other_address = get_le(other + (is64 ? 24 : 12), is64 ? 8 : 4);
+            uint64_t other_memsz = get_le(other + (is64 ? 40 : 20), is64 ? 8 : 4);
+            if (get_le(other, 4) == ELF_PT_LOAD && address < other_address + other_memsz &&
+                other_address < address + memsz)
+            {
+                fprintf(stderr, "Fehler: Segmente %llu und %llu von %s überlappen sich.\n", (unsigned long long)k,
+                        (unsigned long long)i, filename);
+                return 1;
+            }
+        }
+        if (filesz > 0 && place(rom, file, offset, (uint32_t)address, (uint32_t)filesz) != 0)
+        {
+            fprintf(stderr, "Kann ROM-Inhaltsdatei nicht einblenden: %s\n", filename);
+            return 1;
+        }
+        segments++;
+    }
+    if (segments == 0)
+    {
+        fprintf(stderr, "Hinweis: %s enthält keine ladbaren Segmente, der ROM bleibt leer.\n", filename);
+    }
+    return 0;
+}
+
+static int hex_digit(uint8_t c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Dekodiert count Bytes aus 2 * count Hex-Ziffern, gibt 0 bei Erfolg zurück.
+static int hex_bytes(const uint8_t *in, uint8_t *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        int high = hex_digit(in[2 * i]);
+        int low = hex_digit(in[2 * i + 1]);
+        if (high < 0 || low < 0)
+        {
+            return 1;
+        }
+        out[i] = (uint8_t)(high << 4 | low);
+    }
+    return 0;
+}
+
+static int load_ihex(const char *filename, const struct RomFile *file, uint32_t rom_size, struct RomContent *rom)
+{
+    uint8_t *base = rom->mapping;
+    const uint8_t *p = file->data;
+    const uint8_t *end = p + file->size;
+    uint32_t upper = 0; // aus den Datensätzen 02 und 04
+    uint32_t line_no = 0;
+
+    while (p < end)
+    {
+        const uint8_t *line_end = memchr(p, '\n', (size_t)(end - p));
+        if (line_end == NULL)
+        {
+            line_end = end;
+        }
+        const uint8_t *next = line_end < end ? line_end + 1 : end;
+        line_no++;
+        while (line_end > p && (line_end[-1] == '\r' || line_end[-1] == ' ' || line_end[-1] == '\t'))
+        {
+            line_end--;
+        }
+        if (line_end == p)
+        {
+            p = next;
+            continue;
+        }
+
+        uint8_t record[5 + 255];
+        size_t digits = (size_t)(line_end - p) - 1;
+        if (p[0] != ':' || digits < 10 || digits % 2 != 0 || hex_bytes(p + 1, record, 1) != 0 ||
+            digits != 2 * (5 + (size_t)record[0]) || hex_bytes(p + 1, record, digits / 2) != 0)
+        {
+            fprintf(stderr, "Fehler: Zeile %u von %s ist kein gültiger Intel-HEX-Datensatz.\n", line_no, filename);
+            return 1;
+        }
+        uint8_t sum = 0;
+        for (size_t i = 0; i < digits / 2; i++)
+        {
+            sum += record[i];
+        }
+        if (sum != 0)
+        {
+            fprintf(stderr, "Fehler: Prüfsumme in Zeile %u von %s stimmt nicht.\n", line_no, filename);
+            return 1;
+        }
+
+        uint8_t count = record[0];
+        uint32_t offset = (uint32_t)record[1] << 8 | record[2];
+        const uint8_t *data = record + 4;
+        switch (record[3])
+        {
+        case 0x00:
+        {
+            uint64_t address = (uint64_t)upper + offset;
+            if (address + count > rom_size)
+            {
+                fprintf(stderr, "Fehler: Zeile %u von %s schreibt hinter das ROM (Adresse 0x%llx).\n", line_no,
+                        filename, (unsigned long long)address);
+                return 1;
+            }
+            memcpy(base + address, data, count);
+            break;
+        }
+        case 0x01:
+            return 0;
+        case 0x02:
+            upper = ((uint32_t)data[0] << 8 | data[1]) << 4;
+            break;
+        case 0x04:
+            upper = ((uint32_t)data[0] << 8 | data[1]) << 16;
+            break;
+        case 0x03:
+        case 0x05:
+            // Startadresse, für das ROM ohne Bedeutung
+            break;
+        default:
+            fprintf(stderr, "Fehler: Unbekannter Datensatztyp %02X in Zeile %u von %s.\n", record[3], line_no, filename);
+            return 1;
+        }
+        p = next;
+    }
+    fprintf(stderr, "Hinweis: %s endet ohne Intel-HEX-Endedatensatz.\n", filename);
+    return 0;
+}
+
+static enum RomFormat detect_format(const char *filename, const struct RomFile *file)
+{
+    if (file->size >= 4 && memcmp(file->data, "\x7f" "ELF", 4) == 0)
+    {
+        return ROM_FORMAT_ELF;
+    }
+    if (has_extension(filename, ".hex") || has_extension(filename, ".ihex"))
+    {
+        return ROM_FORMAT_IHEX;
+    }
+    if (has_extension(filename, ".bin") || has_extension(filename, ".img"))
+    {
+        return ROM_FORMAT_BIN;
+    }
+    return ROM_FORMAT_TEXT;
+}
+
+// Auf Big-Endian-Hosts erwartet RomImage Wörter in Host-Reihenfolge: einmal umwandeln.
+static int to_host_words(struct RomContent *rom, uint32_t rom_size)
+{
+    uint32_t count = (uint32_t)(((uint64_t)rom_size + 3) / 4);
+    uint32_t *words = malloc(((size_t)count + 1) * sizeof(uint32_t));
+    if (words == NULL)
+    {
+        return 1;
+    }
+    const uint8_t *bytes = rom->mapping;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        words[i] = (uint32_t)get_le(bytes + 4 * (size_t)i, 4);
+    }
+    munmap(rom->mapping, rom->mapping_size);
+    rom->mapping = NULL;
+    rom->mapping_size = 0;
+    rom->words = words;
+    return 0;
+}
+
+int rom_load(const char *filename, uint32_t rom_size, enum RomFormat format, struct RomContent *rom)
+{
+    memset(rom, 0, sizeof(*rom));
+    struct RomFile file;
+    if (open_file(filename, &file) != 0)
+    {
+        return 1;
+    }
+    if (format == ROM_FORMAT_AUTO)
+    {
+        format = detect_format(filename, &file);
+    }
+    if (format == ROM_FORMAT_TEXT)
+    {
+        close_file(&file);
+        rom->words = load_rom_content(filename, rom_size);
+        return rom->words == NULL ? 1 : 0;
+    }
+
+    int rc = reserve(rom, rom_size);
+    if (rc == 0)
+    {
+        if (format == ROM_FORMAT_ELF)
+        {
+            rc = load_elf(filename, &file, rom_size, rom);
+        }
+        else if (format == ROM_FORMAT_IHEX)
+        {
+            rc = load_ihex(filename, &file, rom_size, rom);
+        }
+        else
+        {
+            rc = load_binary(filename, &file, rom_size, rom);
+        }
+    }
+    close_file(&file);
+    if (rc == 0 && !host_is_little_endian())
+    {
+        rc = to_host_words(rom, rom_size);
+    }
+    if (rc == 0 && rom->mapping != NULL)
+    {
+        // Ab hier wie die eingeblendeten Dateiseiten schreibgeschützt
+        rc = mprotect(rom->mapping, rom->mapping_size, PROT_READ);
+    }
+    if (rc != 0)
+    {
+        rom_release(rom);
+        return 1;
+    }
+    return 0;
+}
+
+void rom_release(struct RomContent *rom)
+{
+    if (rom->mapping != NULL)
+    {
+        munmap(rom->mapping, rom->mapping_size);
+    }
+    else
+    {
+        free(rom->words);
+    }
+    memset(rom, 0, sizeof(*rom));
+}
@@ -0,0 +1,42 @@
+#ifndef ROM_LOADER_H
+#define ROM_LOADER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// ROM-Inhalt aus einer Datei (--rom-content, Format nach --rom-format):
+//  - ROM_FORMAT_BIN: Rohabbild ab Adresse 0
+//  - ROM_FORMAT_ELF: PT_LOAD-Segmente eines Little-Endian-ELF (32 oder 64 Bit) an ihrer
+//    physischen Adresse, der Rest bis zur Speichergröße des Segments ist 0
+//  - ROM_FORMAT_IHEX: Intel HEX (Datensätze 00-05)
+//  - ROM_FORMAT_TEXT: eine Zahl (ein 32-Bit-Wort) je Zeile, siehe load_rom_content()
+//  - ROM_FORMAT_AUTO: ELF am Dateianfang erkannt, sonst nach der Endung (.bin/.img, .hex/.ihex),
+//    sonst Text
+// Binärabbilder und ELF-Segmente werden seitenweise schreibgeschützt eingeblendet und auf
+// Little-Endian-Hosts ohne Kopie an die Simulation übergeben; kopiert werden nur Seiten, die nicht
+// vollständig aus der Datei stammen oder deren Versatz in der Datei nicht zur Adresse passt.
+    struct RomContent
+    {
+        // Mindestens rom_size (auf 4 Byte aufgerundet) Bytes im Byte-Layout des ROMs, nach dem
+        // Dateiinhalt mit 0 aufgefüllt. Schreibgeschützt, solange mapping gesetzt ist.
+        uint32_t *words;
+        void *mapping; // NULL: words liegt auf dem Heap
+        size_t mapping_size;
+    };
+
+    // Gibt 0 bei Erfolg zurück; das Ergebnis muss mit rom_release() freigegeben werden.
+    int rom_load(const char *filename, uint32_t rom_size, enum RomFormat format, struct RomContent *rom);
+
+    void rom_release(struct RomContent *rom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ROM_LOADER_H
@@ -0,0 +1,103 @@
+#ifndef ROM_LT_HPP
+#define ROM_LT_HPP
+
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_target_socket.h>
+#include <cstring>
+
+#include "log.h"
+#include "rom_image.hpp"
+#include "rom_prefetcher.hpp"
+using namespace sc_core;
+
+// Loosely-timed Variante des ROMs. Ein Lesezugriff dauert wie im Signalmodell einen Takt für
+// die Übernahme der Anfrage und `latency` Takte bis zur Antwort.
+SC_MODULE(ROM_LT)
+{
+    tlm_utils::simple_target_socket<ROM_LT> socket;
+
+    RomImage memory;
+    uint32_t latency;
+    sc_time period;
+    // Zeilenpuffer mit Prefetcher wie im Signalmodell, mit prefetch_depth = 0 abgeschaltet
+    RomPrefetcher prefetch;
+
+    SC_HAS_PROCESS(ROM_LT);
+
+    ROM_LT(sc_module_name name, uint32_t size, uint32_t *rom_content, uint32_t latency_clk, const sc_time &period, bool take_ownership = false,
+           uint32_t prefetch_depth = 0)
+        : sc_module(name), socket("socket"), memory(size, rom_content, take_ownership), period(period),
+          prefetch(prefetch_depth, memory.size(), latency_clk > 0 ? latency_clk : 3)
+    {
+        if (latency_clk > 0)
+        {
+            latency = latency_clk;
+        }
+        else
+        {
+            latency = 3;
+        }
+        socket.register_b_transport(this, &ROM_LT::b_transport);
+    }
+
+    uint32_t size()
+    {
+        return memory.size();
+    }
+
+    void b_transport(tlm::tlm_generic_payload &trans, sc_time &delay)
+    {
+        uint32_t addresse = static_cast<uint32_t>(trans.get_address());
+        uint32_t result = 0;
+
+        // Der ROM übernimmt die Anfrage einen Takt nach dem Controller.
+        uint32_t cycles = latency;
+        if (prefetch.enabled())
+        {
+            cycles = prefetch.access(addresse, static_cast<uint64_t>((sc_time_stamp() + delay) / period) + 1);
+        }
+        delay += period * (cycles + 1);
+        trans.set_response_status(tlm::TLM_OK_RESPONSE);
+
+        if (trans.get_data_length() != 4)
+        {
+            if (addresse < memory.size())
+            {
+                result = memory[addresse];
+                LOG_DEBUG(LOG_ROM, "ROM hat 1B-Wert gefunden: 0x%08x an Adresse 0x%08x.", result, addresse);
+            }
+            else
+            {
+                SC_REPORT_WARNING("ROM", "Lesezugriff auf nicht zugewiesene Adresse (Byte)");
+                result = 0xFF;
+            }
+            *trans.get_data_ptr() = static_cast<uint8_t>(result);
+            return;
+        }
+
+        if (addresse % 4 != 0)
+        {
+            trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+            memcpy(trans.get_data_ptr(), &result, sizeof(result));
+            return;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            uint32_t curr_addr = addresse + i;
+            if (curr_addr < memory.size())
+            {
+                result |= static_cast<uint32_t>(memory[curr_addr]) << (8 * i);
+            }
+            else
+            {
+                SC_REPORT_WARNING("ROM", "Lesezugriff auf nicht zugewiesene Adresse (Byte)");
+                result |= 0xFF << (8 * i);
+            }
+        }
+        LOG_DEBUG(LOG_ROM, "ROM hat 4B-Wert gefunden: 0x%08x an Adresse 0x%08x.", result, addresse);
+        memcpy(trans.get_data_ptr(), &result, sizeof(result));
+    }
+};
+
+#endif // ROM_LT_HPP
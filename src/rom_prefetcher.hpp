@@ -0,0 +1,202 @@
+#ifndef ROM_PREFETCHER_HPP
+#define ROM_PREFETCHER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "log.h"
+#include "rahmenprogramm.h"
+
+// Zeilenpuffer mit Prefetcher vor dem ROM. Der Puffer hält die zuletzt gelesene Zeile und bis zu
+// `depth` vorausgelesene Zeilen zu je LINE_SIZE Bytes. Ein Treffer kostet einen Takt, ein
+// Fehlzugriff die volle ROM-Latenz (zuzüglich der Wartezeit auf noch laufende Prefetches).
+//
+// Erkannt werden Ströme mit konstantem Abstand zwischen den Zeilen aufeinanderfolgender
+// Zugriffe: Ein sequentieller Strom (Abstand +1) gilt sofort als erkannt, jeder andere Abstand
+// nach zweimaligem Auftreten. Dann werden die nächsten `depth` Zeilen des Stroms gelesen. Das
+// ROM hat nur einen Port, die Prefetches laufen also nacheinander und jeweils mit der vollen
+// Latenz; ein Zugriff auf eine noch nicht eingetroffene Zeile wartet bis zu ihrem Eintreffen.
+//
+// Zeit wird in Takten gezählt, die der Aufrufer angibt. Wird vom signalgenauen ROM, vom LT-Modell
+// und vom Split-Transaction-Controller verwendet.
+class RomPrefetcher
+{
+public:
+    static constexpr uint32_t LINE_SIZE = 16;
+
+    uint64_t reads = 0;       // Lesezugriffe
+    uint64_t buffer_hits = 0; // davon aus dem Zeilenpuffer bedient
+    uint64_t prefetches = 0;  // vorausgelesene Zeilen
+    uint64_t useful = 0;      // davon vor dem Verdrängen mindestens einmal gelesen
+
+    // depth = 0 schaltet den Puffer ab, access() liefert dann immer `latency`.
+    RomPrefetcher(uint32_t depth, uint32_t rom_size, uint32_t latency)
+        : depth(depth), rom_lines((rom_size + LINE_SIZE - 1) / LINE_SIZE), latency(latency), lines(depth > 0 ? depth + 1 : 0)
+    {
+    }
+
+    bool enabled() const
+    {
+        return depth > 0;
+    }
+
+    // Takte, bis die Daten an `address` vorliegen, wenn der Zugriff im Takt `now` beginnt.
+    uint32_t access(uint32_t address, uint64_t now)
+    {
+        if (!enabled())
+        {
+            return latency;
+        }
+        reads++;
+        uint32_t line = address / LINE_SIZE;
+
+        uint32_t cycles = latency;
+        Line *entry = find(line);
+        if (entry != nullptr)
+        {
+            buffer_hits++;
+            cycles = entry->ready_at > now + 1 ? static_cast<uint32_t>(entry->ready_at - now) : 1;
+            if (entry->prefetched && !entry->used)
+            {
+                useful++;
+            }
+            entry->used = true;
+        }
+        else
+        {
+            uint64_t start = port_free > now ? port_free : now;
+            entry = install(line, start + latency, false, line);
+            entry->used = true;
+            cycles = static_cast<uint32_t>(entry->ready_at - now);
+            port_free = entry->ready_at;
+        }
+        entry->last_use = ++clock;
+
+        train(line);
+        if (streaming)
+        {
+            for (uint32_t k = 1; k <= depth; k++)
+            {
+                int64_t target = static_cast<int64_t>(line) + stride * static_cast<int64_t>(k);
+                if (target < 0 || target >= static_cast<int64_t>(rom_lines))
+                {
+                    break;
+                }
+                if (find(static_cast<uint32_t>(target)) != nullptr)
+                {
+                    continue;
+                }
+                uint64_t start = port_free > now ? port_free : now;
+                port_free = start + latency;
+                install(static_cast<uint32_t>(target), port_free, true, line)->last_use = clock;
+                prefetches++;
+            }
+        }
+        return cycles;
+    }
+
+    // Zähler ins Ergebnis übernehmen und mit log = true protokollieren
+    void report(struct Result &result, bool log = true) const
+    {
+        if (!enabled())
+        {
+            return;
+        }
+        if (log)
+        {
+            LOG_INFO(LOG_ROM, "Prefetcher: %llu Lesezugriffe, %llu aus dem Zeilenpuffer, %llu Zeilen vorausgelesen, davon %llu genutzt",
+                     (unsigned long long)reads, (unsigned long long)buffer_hits, (unsigned long long)prefetches,
+                     (unsigned long long)useful);
+        }
+        result.rom_reads = static_cast<uint32_t>(reads);
+        result.rom_buffer_hits = static_cast<uint32_t>(buffer_hits);
+        result.rom_prefetches = static_cast<uint32_t>(prefetches);
+        result.rom_prefetches_useful = static_cast<uint32_t>(useful);
+    }
+
+private:
+    struct Line
+    {
+        bool valid = false;
+        bool prefetched = false; // vom Prefetcher statt von einem Fehlzugriff geladen
+        bool used = false;
+        uint32_t line = 0;
+        uint64_t ready_at = 0; // Takt, in dem die Daten im Puffer liegen
+        uint64_t last_use = 0;
+    };
+
+    uint32_t depth;
+    uint32_t rom_lines;
+    uint32_t latency;
+    std::vector<Line> lines;
+    uint64_t port_free = 0; // Takt, ab dem das ROM einen weiteren Lesezugriff annimmt
+    uint64_t clock = 0;     // für LRU
+
+    // Stromerkennung
+    bool has_last = false;
+    uint32_t last_line = 0;
+    int64_t stride = 0;
+    bool streaming = false;
+
+    Line *find(uint32_t line)
+    {
+        for (Line &l : lines)
+        {
+            if (l.valid && l.line == line)
+            {
+                return &l;
+            }
+        }
+        return nullptr;
+    }
+
+    // Verdrängt die am längsten ungenutzte Zeile, aber nie `keep` (die gerade gelesene). Noch nicht
+    // gelesene vorausgeladene Zeilen werden erst verdrängt, wenn keine andere mehr übrig ist.
+    Line *install(uint32_t line, uint64_t ready_at, bool prefetched, uint32_t keep)
+    {
+        Line *victim = nullptr;
+        for (Line &l : lines)
+        {
+            if (!l.valid)
+            {
+                victim = &l;
+                break;
+            }
+            if (l.line == keep)
+            {
+                continue;
+            }
+            if (victim == nullptr || (l.used && !victim->used) ||
+                (l.used == victim->used && l.last_use < victim->last_use))
+            {
+                victim = &l;
+            }
+        }
+        *victim = Line();
+        victim->valid = true;
+        victim->prefetched = prefetched;
+        victim->line = line;
+        victim->ready_at = ready_at;
+        return victim;
+    }
+
+    void train(uint32_t line)
+    {
+        if (!has_last)
+        {
+            has_last = true;
+            last_line = line;
+            return;
+        }
+        int64_t delta = static_cast<int64_t>(line) - static_cast<int64_t>(last_line);
+        if (delta == 0)
+        {
+            return;
+        }
+        streaming = delta == stride || delta == 1;
+        stride = delta;
+        last_line = line;
+    }
+};
+
+#endif // ROM_PREFETCHER_HPP
@@ -0,0 +1,183 @@
+#ifndef SIM_PROFILE_HPP
+#define SIM_PROFILE_HPP
+
+#include <csignal>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <sys/time.h>
+#include <systemc>
+
+#include "profile.h"
+using namespace sc_core;
+
+#define PROFILE_SAMPLE_US 1000
+
+// Zähler eines Moduls für --profile, als zusätzliche Basisklasse: SC_MODULE(X), public ActivityCounter.
+// Aktivierungen werden immer gezählt (ein Inkrement und ein Zeiger je Aktivierung). Außerdem
+// merkt sich current(), welches Modul gerade einen Prozess ausführt; die Stichproben von
+// profileStartSampling() werden diesem Modul zugeordnet. So lässt sich die Prozessorzeit auf die
+// Module aufteilen, ohne die Uhr bei jeder Aktivierung zu lesen.
+class ActivityCounter
+{
+public:
+    uint64_t activations = 0;
+    volatile uint64_t samples = 0; // vom Signalhandler erhöht
+
+    // Modul, dessen Prozess gerade läuft, nullptr = keiner (Scheduler oder Testbench)
+    static ActivityCounter *volatile &current()
+    {
+        static ActivityCounter *volatile running = nullptr;
+        return running;
+    }
+
+    void activated()
+    {
+        activations++;
+        current() = this;
+    }
+};
+
+// Zu Beginn einer SC_METHOD anlegen: zählt die Aktivierung und ordnet die Methode bis zu ihrem
+// Ende dem Modul zu.
+class ActivityScope
+{
+public:
+    explicit ActivityScope(ActivityCounter &counter)
+    {
+        counter.activated();
+    }
+
+    ~ActivityScope()
+    {
+        ActivityCounter::current() = nullptr;
+    }
+
+    ActivityScope(const ActivityScope &) = delete;
+    ActivityScope &operator=(const ActivityScope &) = delete;
+};
+
+// In einem Modul mit SC_THREAD: ersetzt sc_module::wait(), damit jede Rückkehr aus wait() als
+// Aktivierung zählt.
+#define PROFILED_WAIT                                                \
+    template <typename... Args>                                      \
+    void wait(Args &&...args)                                        \
+    {                                                                \
+        ActivityCounter::current() = nullptr;                        \
+        ::sc_core::sc_module::wait(std::forward<Args>(args)...);     \
+        activated();                                                 \
+    }
+
+// Anzahl der Aufrufe von profiledStart() im Prozess
+inline uint64_t &profileStarts()
+{
+    static uint64_t starts = 0;
+    return starts;
+}
+
+// sc_start() mit Zähler für --profile
+template <typename... Args>
+inline void profiledStart(Args &&...args)
+{
+    profileStarts()++;
+    sc_start(std::forward<Args>(args)...);
+}
+
+inline struct SimProfile *&profileSampled()
+{
+    static struct SimProfile *profile = nullptr;
+    return profile;
+}
+
+inline void profileOnSample(int)
+{
+    struct SimProfile *profile = profileSampled();
+    if (profile == nullptr)
+    {
+        return;
+    }
+    profile->samples++;
+    ActivityCounter *running = ActivityCounter::current();
+    if (running != nullptr)
+    {
+        running->samples++;
+    }
+    else
+    {
+        profile->kernel_samples++;
+    }
+}
+
+// Stichproben alle PROFILE_SAMPLE_US Mikrosekunden Prozessorzeit (SIGPROF), profile darf NULL sein.
+inline void profileStartSampling(struct SimProfile *profile)
+{
+    if (profile == nullptr)
+    {
+        return;
+    }
+    profile->sample_us = PROFILE_SAMPLE_US;
+    profileSampled() = profile;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = profileOnSample;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, nullptr);
+    struct itimerval timer;
+    timer.it_interval.tv_sec = PROFILE_SAMPLE_US / 1000000;
+    timer.it_interval.tv_usec = PROFILE_SAMPLE_US % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+inline void profileStopSampling()
+{
+    if (profileSampled() == nullptr)
+    {
+        return;
+    }
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    // Ein noch ausstehendes SIGPROF würde den Prozess sonst beenden
+    signal(SIGPROF, SIG_IGN);
+    profileSampled() = nullptr;
+}
+
+inline void profileCollectModules(struct SimProfile *profile, sc_object *object)
+{
+    ActivityCounter *counter = dynamic_cast<ActivityCounter *>(object);
+    if (counter != nullptr && profile->module_count < PROFILE_MAX_MODULES)
+    {
+        struct ModuleProfile *m = &profile->modules[profile->module_count++];
+        strncpy(m->name, object->name(), sizeof(m->name) - 1);
+        m->name[sizeof(m->name) - 1] = '\0';
+        m->activations = counter->activations;
+        m->samples = counter->samples;
+    }
+    for (sc_object *child : object->get_child_objects())
+    {
+        profileCollectModules(profile, child);
+    }
+}
+
+// Beendet die Stichproben und trägt Delta-Zyklen, sc_start()-Aufrufe und die Zähler aller Module
+// ein. Vor dem Löschen der Module aufrufen; profile darf NULL sein.
+inline void profileCollect(struct SimProfile *profile)
+{
+    if (profile == nullptr)
+    {
+        return;
+    }
+    profileStopSampling();
+    profile->delta_cycles = sc_delta_count();
+    profile->sc_starts = profileStarts();
+    profile->module_count = 0;
+    for (sc_object *object : sc_get_top_level_objects())
+    {
+        profileCollectModules(profile, object);
+    }
+}
+
+#endif // SIM_PROFILE_HPP
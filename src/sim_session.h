@@ -0,0 +1,65 @@
+#ifndef SIM_SESSION_H
+#define SIM_SESSION_H
+
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// Sitzung mit dem signalgenauen Modell (--mode signal): Die Netzliste wird einmal elaboriert und
+// bleibt bestehen, Anfragen können in beliebig vielen Stapeln übergeben werden. So lassen sich
+// endlose Anfrageströme mit festem Speicherbedarf simulieren oder das Modell aus einer
+// Co-Simulation heraus Schritt für Schritt treiben. Die Anfragen eines Stapels werden wie bei
+// run_simulation_ext() nacheinander gestellt, nur ohne Zyklengrenze; die Zeit läuft über alle
+// Stapel weiter.
+//
+// SystemC kann nicht neu elaborieren: Je Prozess ist nur eine Sitzung möglich, und daneben darf
+// keine run_simulation*-Funktion aufgerufen werden. Getrennte Master (split_users) werden nicht
+// unterstützt.
+    struct SimSession;
+
+    struct SessionStats
+    {
+        uint64_t requests; // beantwortete Anfragen
+        uint64_t errors;
+        uint64_t cycles;   // aktueller Takt
+        uint32_t pending;  // übergebene, noch nicht simulierte Anfragen
+        struct Result result; // Zähler der Module wie bei run_simulation_ext(), cycles/errors bei UINT32_MAX begrenzt
+    };
+
+    // Liefert bis zu max Anfragen nach buf und gibt ihre Anzahl zurück, 0 = Ende des Stroms.
+    typedef uint32_t (*request_source_fn)(void *context, struct Request *buf, uint32_t max);
+
+    // Parameter wie bei run_simulation_ext(). romContent und options->stats müssen bis
+    // sim_session_destroy() gültig bleiben. Gibt NULL zurück, wenn keine Sitzung möglich ist oder
+    // --ram file: nicht eingeblendet werden kann.
+    struct SimSession *sim_session_create(const char *tracefile, uint32_t latencyRom, uint32_t romSize, uint32_t blockSize,
+                                          uint32_t *romContent, const struct SimOptions *options);
+
+    // Kopiert die Anfragen in die Warteschlange der Sitzung, simuliert wird erst mit sim_session_run().
+    int sim_session_submit(struct SimSession *session, const struct Request *requests, uint32_t count);
+
+    // Simuliert alle übergebenen Anfragen, bis das Modell wieder ruht.
+    int sim_session_run(struct SimSession *session);
+
+    // Simuliert `cycles` Takte ohne Anfragen, z.B. um einer Co-Simulation zu folgen. Nur ohne
+    // wartende Anfragen möglich.
+    int sim_session_advance(struct SimSession *session, uint64_t cycles);
+
+    // Holt Anfragen in Stapeln zu höchstens `chunk` aus source und simuliert sie, bis source 0
+    // liefert. Der Puffer wird dabei wiederverwendet.
+    int sim_session_stream(struct SimSession *session, request_source_fn source, void *context, uint32_t chunk);
+
+    void sim_session_stats(const struct SimSession *session, struct SessionStats *stats);
+
+    // Gibt die Zähler im Log aus, schließt die Trace-Datei und baut die Netzliste ab.
+    void sim_session_destroy(struct SimSession *session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_SESSION_H
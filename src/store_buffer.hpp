@@ -0,0 +1,211 @@
+#ifndef STORE_BUFFER_HPP
+#define STORE_BUFFER_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "log.h"
+#include "rahmenprogramm.h"
+
+// Schreibpuffer des Memory-Controllers. Schreibzugriffe auf den Hauptspeicher landen in bis zu
+// `entries` Einträgen zu je `line` Bytes; ein weiterer Zugriff auf eine schon gepufferte Zeile wird
+// mit ihr zusammengefasst, egal ob 1 Byte oder 4 Bytes. Lesezugriffe, deren Bytes alle im Puffer
+// liegen, werden von dort beantwortet. Geleert wird in Reihenfolge der Einträge (älteste zuerst),
+// je Speicherzugriff ein Wort mit den gültigen Bytes als Byte-Enable.
+//
+// Der Puffer kennt keine Besitzer: Der Controller prüft jeden Zugriff wie ohne Puffer mit
+// protection(), bevor er ihn hier ablegt oder beantwortet. Abgewiesene Zugriffe erreichen den
+// Puffer also nie, und Zuteilungen und Freigaben von Blöcken wirken in Reihenfolge der Anfragen.
+class StoreBuffer
+{
+public:
+    uint64_t writes = 0;      // gepufferte Schreibzugriffe
+    uint64_t coalesced = 0;   // davon ohne neuen Eintrag mit einer gepufferten Zeile zusammengefasst
+    uint64_t forwarded = 0;   // aus dem Puffer beantwortete Lesezugriffe
+    uint64_t mem_writes = 0;  // Speicherzugriffe beim Leeren
+    uint64_t forced = 0;      // davon erzwungen (Puffer voll oder Lesezugriff auf gepufferte Bytes)
+
+    // entries = 0 schaltet den Puffer ab; line ist eine Zweierpotenz ab 4.
+    StoreBuffer(uint32_t entries, uint32_t line)
+        : entries(entries), line(line), bases(entries), data(static_cast<size_t>(entries) * line),
+          valid(static_cast<size_t>(entries) * line)
+    {
+    }
+
+    bool enabled() const
+    {
+        return entries > 0;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    // Legt n (1 oder 4) Bytes von value ab address ab, Little Endian und wie PagedMemory nicht
+    // über 0xFFFFFFFF hinaus. Gibt false zurück, wenn dafür Einträge fehlen; der Aufrufer leert
+    // dann erst einen Teil des Puffers.
+    bool put(uint32_t address, uint32_t value, uint32_t n)
+    {
+        uint32_t last = n - 1 > UINT32_MAX - address ? UINT32_MAX : address + n - 1;
+        uint32_t needed = find(lineOf(address)) < 0 ? 1 : 0;
+        if (lineOf(last) != lineOf(address) && find(lineOf(last)) < 0)
+        {
+            needed++;
+        }
+        if (count + needed > entries)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t byte_addr = address + i;
+            int slot = find(lineOf(byte_addr));
+            if (slot < 0)
+            {
+                slot = allocate(lineOf(byte_addr));
+            }
+            size_t index = static_cast<size_t>(slot) * line + (byte_addr & (line - 1));
+            data[index] = (value >> (i * 8)) & 0xFF;
+            valid[index] = 1;
+            if (byte_addr == UINT32_MAX)
+            {
+                break;
+            }
+        }
+        writes++;
+        if (needed == 0)
+        {
+            coalesced++;
+        }
+        return true;
+    }
+
+    // Liest n Bytes ab address (mit Umlauf auf 0 wie PagedMemory), wenn alle im Puffer liegen.
+    bool lookup(uint32_t address, uint32_t n, uint32_t &value)
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t byte_addr = address + i;
+            int slot = find(lineOf(byte_addr));
+            if (slot < 0 || !valid[static_cast<size_t>(slot) * line + (byte_addr & (line - 1))])
+            {
+                return false;
+            }
+            result |= static_cast<uint32_t>(data[static_cast<size_t>(slot) * line + (byte_addr & (line - 1))]) << (i * 8);
+        }
+        value = result;
+        forwarded++;
+        return true;
+    }
+
+    // Liegt eines der n Bytes ab address im Puffer?
+    bool overlaps(uint32_t address, uint32_t n) const
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t byte_addr = address + i;
+            int slot = find(lineOf(byte_addr));
+            if (slot >= 0 && valid[static_cast<size_t>(slot) * line + (byte_addr & (line - 1))])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Entnimmt das erste Wort mit gültigen Bytes aus dem ältesten Eintrag: ausgerichtete Adresse,
+    // Daten und Byte-Enable. Der Puffer darf nicht leer sein.
+    void drainWord(uint32_t &address, uint32_t &value, uint8_t &strobe, bool is_forced)
+    {
+        size_t first = static_cast<size_t>(head) * line;
+        address = value = 0;
+        strobe = 0;
+        for (uint32_t offset = 0; offset < line && strobe == 0; offset += 4)
+        {
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                if (valid[first + offset + i])
+                {
+                    valid[first + offset + i] = 0;
+                    value |= static_cast<uint32_t>(data[first + offset + i]) << (i * 8);
+                    strobe |= 1u << i;
+                }
+            }
+            address = bases[head] + offset;
+        }
+        bool rest = false;
+        for (uint32_t i = 0; i < line && !rest; i++)
+        {
+            rest = valid[first + i] != 0;
+        }
+        if (!rest)
+        {
+            head = (head + 1) % entries;
+            count--;
+        }
+        mem_writes++;
+        if (is_forced)
+        {
+            forced++;
+        }
+    }
+
+    // Zähler ins Ergebnis übernehmen und mit log = true protokollieren
+    void report(struct Result &result, bool log = true) const
+    {
+        if (!enabled())
+        {
+            return;
+        }
+        if (log)
+        {
+            LOG_INFO(LOG_MC, "Schreibpuffer: %llu Schreibzugriffe, davon %llu zusammengefasst, %llu Lesezugriffe weitergeleitet, "
+                             "%llu Speicherzugriffe (%llu erzwungen), %u Zeilen noch nicht geschrieben",
+                     (unsigned long long)writes, (unsigned long long)coalesced, (unsigned long long)forwarded,
+                     (unsigned long long)mem_writes, (unsigned long long)forced, count);
+        }
+        result.store_writes = static_cast<uint32_t>(writes);
+        result.store_coalesced = static_cast<uint32_t>(coalesced);
+        result.store_forwarded = static_cast<uint32_t>(forwarded);
+        result.store_mem_writes = static_cast<uint32_t>(mem_writes);
+    }
+
+private:
+    uint32_t entries;
+    uint32_t line;
+    std::vector<uint32_t> bases; // Zeilenadresse je Eintrag
+    std::vector<uint8_t> data;   // line Bytes je Eintrag
+    std::vector<uint8_t> valid;  // 1 = Byte geschrieben
+    uint32_t head = 0;           // ältester Eintrag
+    uint32_t count = 0;
+
+    uint32_t lineOf(uint32_t address) const
+    {
+        return address & ~(line - 1);
+    }
+
+    int find(uint32_t base) const
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t slot = (head + i) % entries;
+            if (bases[slot] == base)
+            {
+                return static_cast<int>(slot);
+            }
+        }
+        return -1;
+    }
+
+    int allocate(uint32_t base)
+    {
+        uint32_t slot = (head + count) % entries;
+        bases[slot] = base;
+        count++;
+        return static_cast<int>(slot);
+    }
+};
+
+#endif // STORE_BUFFER_HPP
@@ -0,0 +1,328 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "sweep.h"
+#include "rom_loader.h"
+#include "log.h"
+
+// Obergrenze für die Länge einer Werteliste, damit Tippfehler wie "1:4000000000" nicht
+// Milliarden von Punkten erzeugen
+#define SWEEP_MAX_VALUES 65536
+
+// Ergebnis eines Punktes im gemeinsam genutzten Speicher
+struct SweepPoint
+{
+    uint32_t latency_rom;
+    uint32_t block_size;
+    uint32_t rom_size;
+    int status; // 0 = ok, sonst fehlgeschlagen
+    double seconds;
+    struct Result result;
+};
+
+static int append_value(struct SweepList *list, uint32_t value)
+{
+    if (list->count >= SWEEP_MAX_VALUES)
+    {
+        fprintf(stderr, "Fehler: Sweep-Liste hat mehr als %d Werte.\n", SWEEP_MAX_VALUES);
+        return 1;
+    }
+    if ((list->count & (list->count - 1)) == 0)
+    {
+        uint32_t capacity = list->count ? list->count * 2 : 1;
+        uint32_t *grown = realloc(list->values, capacity * sizeof(uint32_t));
+        if (!grown)
+        {
+            return 1;
+        }
+        list->values = grown;
+    }
+    list->values[list->count++] = value;
+    return 0;
+}
+
+int sweep_parse_list(const char *spec, uint32_t fallback, struct SweepList *list)
+{
+    list->values = NULL;
+    list->count = 0;
+    if (spec == NULL)
+    {
+        return append_value(list, fallback);
+    }
+
+    const char *item = spec;
+    while (*item != '\0')
+    {
+        const char *end = strchr(item, ',');
+        size_t len = end ? (size_t)(end - item) : strlen(item);
+        const char *colon = memchr(item, ':', len);
+        uint32_t start;
+
+        if (colon == NULL)
+        {
+            if (parse_number_n(item, len, &start) != 0 || append_value(list, start) != 0)
+            {
+                goto invalid;
+            }
+        }
+        else
+        {
+            const char *colon2 = memchr(colon + 1, ':', len - (colon + 1 - item));
+            const char *stop_end = colon2 ? colon2 : item + len;
+            uint32_t stop;
+            uint32_t step = 1;
+            bool multiply = false;
+            if (parse_number_n(item, colon - item, &start) != 0 ||
+                parse_number_n(colon + 1, stop_end - (colon + 1), &stop) != 0)
+            {
+                goto invalid;
+            }
+            if (colon2 != NULL)
+            {
+                const char *step_str = colon2 + 1;
+                multiply = step_str < item + len && *step_str == '*';
+                step_str += multiply ? 1 : 0;
+                if (parse_number_n(step_str, item + len - step_str, &step) != 0)
+                {
+                    goto invalid;
+                }
+            }
+            if (start > stop || step == 0 || (multiply && (step < 2 || start == 0)))
+            {
+                goto invalid;
+            }
+            for (uint64_t value = start; value <= stop; value = multiply ? value * step : value + step)
+            {
+                if (append_value(list, (uint32_t)value) != 0)
+                {
+                    sweep_free_list(list);
+                    return 1;
+                }
+            }
+        }
+
+        item += len;
+        if (*item == ',')
+        {
+            item++;
+        }
+    }
+    if (list->count > 0)
+    {
+        return 0;
+    }
+
+invalid:
+    fprintf(stderr, "Ungültige Sweep-Liste: %s\n", spec);
+    sweep_free_list(list);
+    return 1;
+}
+
+void sweep_free_list(struct SweepList *list)
+{
+    free(list->values);
+    list->values = NULL;
+    list->count = 0;
+}
+
+static double now_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Läuft im Kindprozess: einen Punkt simulieren und das Ergebnis eintragen
+static void run_point(const MemConfig *config, simulate_fn simulate, struct SweepPoint *point,
+                      uint32_t num_requests, struct Request *requests)
+{
+    freopen("/dev/null", "w", stdout);
+    freopen("/dev/null", "w", stderr);
+    log_set_levels("off");
+
+    // Der ROM-Inhalt hängt von der ROM-Größe ab und wird deshalb je Punkt geladen.
+    struct RomContent rom = {0};
+    if (config->rom_content_file != NULL &&
+        rom_load(config->rom_content_file, point->rom_size, config->rom_format, &rom) != 0)
+    {
+        _exit(1);
+    }
+
+    double start = now_seconds();
+    point->result = simulate(config->cycles, NULL, point->latency_rom, point->rom_size, point->block_size,
+                             rom.words, num_requests, requests, &config->options);
+    point->seconds = now_seconds() - start;
+    point->status = 0;
+    _exit(0);
+}
+
+static void write_results(FILE *out, bool json, const struct SweepPoint *points, uint32_t count)
+{
+    if (json)
+    {
+        fprintf(out, "[\n");
+    }
+    else
+    {
+        fprintf(out, "latency_rom,block_size,rom_size,status,cycles,errors,cache_hits,cache_misses,cache_writebacks,dram_row_hits,dram_row_misses,dram_row_conflicts,rom_reads,rom_buffer_hits,rom_prefetches,rom_prefetches_useful,store_writes,store_coalesced,store_forwarded,store_mem_writes,seconds\n");
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const struct SweepPoint *p = &points[i];
+        if (json)
+        {
+            fprintf(out, "  {\"latency_rom\": %u, \"block_size\": %u, \"rom_size\": %u, \"status\": \"%s\", "
+                         "\"cycles\": %u, \"errors\": %u, \"cache_hits\": %u, \"cache_misses\": %u, "
+                         "\"cache_writebacks\": %u, \"dram_row_hits\": %u, \"dram_row_misses\": %u, "
+                         "\"dram_row_conflicts\": %u, \"rom_reads\": %u, \"rom_buffer_hits\": %u, "
+                         "\"rom_prefetches\": %u, \"rom_prefetches_useful\": %u, \"store_writes\": %u, "
+                         "\"store_coalesced\": %u, \"store_forwarded\": %u, \"store_mem_writes\": %u, \"seconds\": %.6f}%s\n",
+                    p->latency_rom, p->block_size, p->rom_size, p->status == 0 ? "ok" : "failed",
+                    p->result.cycles, p->result.errors, p->result.cache_hits, p->result.cache_misses,
+                    p->result.cache_writebacks, p->result.dram_row_hits, p->result.dram_row_misses,
+                    p->result.dram_row_conflicts, p->result.rom_reads, p->result.rom_buffer_hits,
+                    p->result.rom_prefetches, p->result.rom_prefetches_useful, p->result.store_writes,
+                    p->result.store_coalesced, p->result.store_forwarded, p->result.store_mem_writes, p->seconds,
+                    i + 1 < count ? "," : "");
+        }
+        else
+        {
+            fprintf(out, "%u,%u,%u,%s,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%.6f\n", p->latency_rom, p->block_size, p->rom_size,
+                    p->status == 0 ? "ok" : "failed", p->result.cycles, p->result.errors, p->result.cache_hits,
+                    p->result.cache_misses, p->result.cache_writebacks, p->result.dram_row_hits,
+                    p->result.dram_row_misses, p->result.dram_row_conflicts, p->result.rom_reads,
+                    p->result.rom_buffer_hits, p->result.rom_prefetches, p->result.rom_prefetches_useful,
+                    p->result.store_writes, p->result.store_coalesced, p->result.store_forwarded,
+                    p->result.store_mem_writes, p->seconds);
+        }
+    }
+    if (json)
+    {
+        fprintf(out, "]\n");
+    }
+}
+
+int run_sweep(const MemConfig *config, simulate_fn simulate, const struct SweepList *latencies,
+              const struct SweepList *block_sizes, const struct SweepList *rom_sizes, uint32_t jobs,
+              const char *out_file, uint32_t num_requests, struct Request *requests)
+{
+    // Jeder Punkt würde die Datei mit O_TRUNC neu anlegen und gemeinsam eingeblendet beschreiben.
+    if (config->options.ram_file != NULL)
+    {
+        fprintf(stderr, "Fehler: --ram file: geht nicht mit einem Sweep.\n");
+        return 1;
+    }
+    uint64_t count64 = (uint64_t)latencies->count * block_sizes->count * rom_sizes->count;
+    if (count64 > SWEEP_MAX_VALUES)
+    {
+        fprintf(stderr, "Fehler: Der Sweep hätte %llu Punkte (höchstens %d).\n", (unsigned long long)count64, SWEEP_MAX_VALUES);
+        return 1;
+    }
+    uint32_t count = (uint32_t)count64;
+    if (jobs == 0)
+    {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        jobs = cpus > 0 ? (uint32_t)cpus : 1;
+    }
+
+    // Ergebnisse in gemeinsam genutztem Speicher, die Kinder schreiben sie direkt hinein. Die
+    // Anfragen erben die Kinder mit fork() ohne Kopie; solange niemand schreibt, teilen sich alle
+    // Prozesse dieselben Seiten.
+    size_t points_size = count * sizeof(struct SweepPoint);
+    struct SweepPoint *points = mmap(NULL, points_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (points == MAP_FAILED)
+    {
+        fprintf(stderr, "Fehler: Kein gemeinsamer Speicher für den Sweep.\n");
+        return 1;
+    }
+
+    uint32_t n = 0;
+    for (uint32_t l = 0; l < latencies->count; l++)
+    {
+        for (uint32_t b = 0; b < block_sizes->count; b++)
+        {
+            for (uint32_t r = 0; r < rom_sizes->count; r++)
+            {
+                points[n].latency_rom = latencies->values[l];
+                points[n].block_size = block_sizes->values[b];
+                points[n].rom_size = rom_sizes->values[r];
+                points[n].status = 1;
+                n++;
+            }
+        }
+    }
+
+    fprintf(stderr, "Sweep: %u Punkte mit bis zu %u Prozessen\n", count, jobs);
+    fflush(NULL);
+    uint32_t next = 0;
+    uint32_t running = 0;
+    uint32_t failed = 0;
+    while (next < count || running > 0)
+    {
+        if (next < count && running < jobs)
+        {
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                run_point(config, simulate, &points[next], num_requests, requests);
+            }
+            if (pid < 0)
+            {
+                // Ohne neuen Prozess erst auf einen laufenden warten
+                if (running == 0)
+                {
+                    fprintf(stderr, "Fehler: fork() fehlgeschlagen.\n");
+                    failed += count - next;
+                    break;
+                }
+            }
+            else
+            {
+                next++;
+                running++;
+                continue;
+            }
+        }
+
+        int status;
+        if (wait(&status) > 0)
+        {
+            running--;
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            {
+                failed++;
+            }
+        }
+    }
+
+    FILE *out = stdout;
+    if (out_file != NULL)
+    {
+        out = fopen(out_file, "w");
+        if (!out)
+        {
+            fprintf(stderr, "Kann Sweep-Ergebnisdatei nicht anlegen: %s\n", out_file);
+            out = stdout;
+        }
+    }
+    size_t name_len = out_file ? strlen(out_file) : 0;
+    bool json = name_len >= 5 && strcmp(out_file + name_len - 5, ".json") == 0;
+    write_results(out, json, points, count);
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    munmap(points, points_size);
+    if (failed > 0)
+    {
+        fprintf(stderr, "Sweep: %u Punkte fehlgeschlagen.\n", failed);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // Werteliste eines Sweep-Parameters
+    struct SweepList
+    {
+        uint32_t *values;
+        uint32_t count;
+    };
+
+    // Liest eine Liste wie "1,2,4", "1:8" (Schritt 1), "0:64:16" oder "256:4096:*2"
+    // (Faktor statt Schritt). Ohne Angabe (spec == NULL) enthält die Liste nur fallback.
+    // Gibt 0 bei Erfolg zurück.
+    int sweep_parse_list(const char *spec, uint32_t fallback, struct SweepList *list);
+
+    void sweep_free_list(struct SweepList *list);
+
+    // Simuliert alle Kombinationen aus ROM-Latenz, Blockgröße und ROM-Größe in höchstens
+    // `jobs` gleichzeitigen Kindprozessen (SystemC erlaubt nur eine Simulation je Prozess) und
+    // schreibt die Ergebnisse als CSV bzw. bei der Endung ".json" als JSON nach out_file
+    // (NULL = stdout). Die Anfragen liegen dabei in einem gemeinsam genutzten Speicherbereich.
+    // Mit --ram file: (options.ram_file) wird abgelehnt, da alle Punkte dieselbe Datei bespielen.
+    // Gibt 0 zurück, wenn alle Punkte simuliert werden konnten.
+    int run_sweep(const MemConfig *config, simulate_fn simulate, const struct SweepList *latencies,
+                  const struct SweepList *block_sizes, const struct SweepList *rom_sizes, uint32_t jobs,
+                  const char *out_file, uint32_t num_requests, struct Request *requests);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SWEEP_H
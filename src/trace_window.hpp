@@ -0,0 +1,336 @@
+#ifndef TRACE_WINDOW_HPP
+#define TRACE_WINDOW_HPP
+
+#include <systemc.h>
+
+#include <functional>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "rahmenprogramm.h"
+#include "log.h"
+#include "sim_profile.hpp"
+#include "vcd_writer.hpp"
+
+// Ein aufzuzeichnendes Signal: für sc_trace und für den SIGNAL_RECORDER
+struct TraceProbe
+{
+  std::string name;
+  unsigned width;
+  std::function<void(sc_trace_file *)> trace;
+  std::function<uint32_t()> read;
+  std::function<void(sc_sensitive &)> sensitize;
+};
+
+// Tastet die Signale bei jeder Änderung ab und gibt geänderte Werte an einen AsyncVcdWriter
+// weiter. Ohne Writer wartet die Methode auf `wake` statt auf die Signale und wird also außerhalb
+// des Aufzeichnungsfensters nicht aufgerufen.
+SC_MODULE(SIGNAL_RECORDER), public ActivityCounter
+{
+  SC_HAS_PROCESS(SIGNAL_RECORDER);
+
+  SIGNAL_RECORDER(sc_module_name name, const std::vector<TraceProbe> &probes)
+      : sc_module(name), probes(probes), last(probes.size())
+  {
+    SC_METHOD(sample);
+    for (const TraceProbe &probe : probes)
+    {
+      probe.sensitize(sensitive);
+    }
+  }
+
+  void start(AsyncVcdWriter *writer)
+  {
+    this->writer = writer;
+    first = true;
+    wake.notify(SC_ZERO_TIME);
+  }
+
+  void stop()
+  {
+    writer = nullptr;
+  }
+
+  void sample()
+  {
+    ActivityScope scope(*this);
+    if (writer == nullptr)
+    {
+      next_trigger(wake);
+      return;
+    }
+    uint64_t now = sc_time_stamp().value();
+    for (size_t i = 0; i < probes.size(); i++)
+    {
+      uint32_t value = probes[i].read();
+      if (first || value != last[i])
+      {
+        last[i] = value;
+        writer->push(now, static_cast<uint32_t>(i), value);
+      }
+    }
+    first = false;
+  }
+
+private:
+  const std::vector<TraceProbe> &probes;
+  std::vector<uint32_t> last;
+  AsyncVcdWriter *writer = nullptr;
+  bool first = true;
+  sc_event wake;
+};
+
+// Zeichnet ausgewählte Signale nur in einem Zeitfenster auf. Die VCD-Datei wird erst beim
+// Öffnen des Fensters angelegt und an seinem Ende geschlossen, außerhalb des Fensters kostet die
+// Aufzeichnung also nichts. Der Takt wird nur auf ausdrücklichen Wunsch ("clk") aufgezeichnet,
+// er ergibt sich aus den Zeitstempeln.
+//
+// Mit SimOptions.trace_writer == TRACE_WRITER_ASYNC (oder einem Dateinamen auf ".gz") schreibt
+// statt sc_create_vcd_trace_file() ein AsyncVcdWriter im Hintergrund.
+//
+// Die Testbench meldet jede Anfrage mit onRequest() und ruft nach jedem sc_start() update()
+// auf. Mit limit() begrenzt sie die Schritte so, dass das Fenster taktgenau beginnt und endet.
+// Takte werden mit 64 Bit gezählt, da Sitzungen (sim_session.h) länger als 2^32 Takte laufen.
+class TraceWindow
+{
+public:
+  // filename: Name aus --tf; für den SystemC-Writer ohne ".vcd", das SystemC selbst anhängt
+  TraceWindow(const std::string &filename, const struct SimOptions &opts)
+      : filename(filename), start(opts.trace_start), end(opts.trace_end),
+        end_relative(opts.trace_end_relative), trigger(opts.trace_trigger),
+        trigger_index(opts.trace_trigger_index), trigger_lo(opts.trace_trigger_lo),
+        trigger_hi(opts.trace_trigger_hi), triggered(opts.trace_trigger == TRACE_TRIGGER_NONE)
+  {
+    bool compressed = filename.size() >= 3 && filename.compare(filename.size() - 3, 3, ".gz") == 0;
+    async = opts.trace_writer == TRACE_WRITER_ASYNC || compressed;
+    if (async && !compressed && (filename.size() < 4 || filename.compare(filename.size() - 4, 4, ".vcd") != 0))
+    {
+      this->filename += ".vcd";
+    }
+    if (!async && filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".vcd") == 0)
+    {
+      this->filename.erase(filename.size() - 4);
+    }
+
+    std::string list = opts.trace_signals != nullptr ? opts.trace_signals : "all";
+    size_t pos = 0;
+    while (pos <= list.size())
+    {
+      size_t comma = list.find(',', pos);
+      if (comma == std::string::npos)
+      {
+        comma = list.size();
+      }
+      if (comma > pos)
+      {
+        selection.insert(list.substr(pos, comma - pos));
+      }
+      pos = comma + 1;
+    }
+  }
+
+  ~TraceWindow()
+  {
+    close();
+  }
+
+  // Meldet ein Signal an. group fasst Signale für die Auswahl zusammen; Signale ohne Gruppe
+  // (nur der Takt) werden von "all" nicht erfasst.
+  template <class T>
+  void add(T &signal, const char *name, const char *group)
+  {
+    if (!isSelected(name, group))
+    {
+      return;
+    }
+    used.insert(name);
+    if (group != nullptr)
+    {
+      used.insert(group);
+    }
+    using Value = typename std::decay<decltype(signal.read())>::type;
+    TraceProbe probe;
+    probe.name = name;
+    probe.width = std::is_same<Value, bool>::value ? 1 : 8 * sizeof(Value);
+    probe.trace = [&signal, name](sc_trace_file *tf)
+    { sc_trace(tf, signal, name); };
+    probe.read = [&signal]()
+    { return static_cast<uint32_t>(signal.read()); };
+    probe.sensitize = [&signal](sc_sensitive &sensitive)
+    { sensitive << signal; };
+    probes.push_back(probe);
+  }
+
+  // Nach dem Anmelden aller Signale und noch vor sc_start() aufrufen: Warnt vor Namen in der
+  // Auswahl, zu denen es kein Signal gibt, und legt für den AsyncVcdWriter den Abtaster an.
+  void elaborate()
+  {
+    if (async && !probes.empty())
+    {
+      recorder = new SIGNAL_RECORDER("trace_recorder", probes);
+    }
+
+    for (const std::string &name : selection)
+    {
+      if (name != "all" && used.count(name) == 0)
+      {
+        LOG_WARN(LOG_TB, "Unbekanntes Signal oder unbekannte Gruppe in --trace-signals: %s", name.c_str());
+      }
+    }
+  }
+
+  // Prüft den Auslöser für die Anfrage `index`, die im Takt `now` gestellt wird.
+  void onRequest(size_t index, const struct Request &req, uint64_t now)
+  {
+    if (!triggered)
+    {
+      triggered = trigger == TRACE_TRIGGER_NONE ||
+                  (trigger == TRACE_TRIGGER_REQUEST && index == trigger_index) ||
+                  (trigger == TRACE_TRIGGER_ADDRESS && req.addr >= trigger_lo && req.addr <= trigger_hi);
+    }
+    update(now);
+  }
+
+  // Öffnet bzw. schließt die Datei, wenn `now` eine Grenze des Fensters erreicht hat.
+  void update(uint64_t now)
+  {
+    if (state == WAITING && triggered && now >= start)
+    {
+      uint64_t stop = end_relative ? now + end : end;
+      if (end == 0 || stop > now)
+      {
+        open(now, end == 0 ? 0 : stop);
+      }
+      else
+      {
+        state = DONE;
+      }
+    }
+    if (state == OPEN && end_at != 0 && now >= end_at)
+    {
+      LOG_INFO(LOG_TB, "Tracing bis Takt %llu", (unsigned long long)now);
+      close();
+    }
+  }
+
+  // Begrenzt einen Simulationsschritt von `budget` Takten (0 = unbegrenzt) auf die nächste
+  // Fenstergrenze nach `now`.
+  uint32_t limit(uint64_t now, uint32_t budget) const
+  {
+    uint64_t boundary = 0;
+    if (state == WAITING && triggered && start > now)
+    {
+      boundary = start;
+    }
+    else if (state == OPEN && end_at > now)
+    {
+      boundary = end_at;
+    }
+    if (boundary == 0 || (budget != 0 && boundary - now >= budget))
+    {
+      return budget;
+    }
+    return static_cast<uint32_t>(boundary - now);
+  }
+
+  void close()
+  {
+    if (tf != nullptr)
+    {
+      sc_close_vcd_trace_file(tf);
+      tf = nullptr;
+    }
+    if (writer != nullptr)
+    {
+      recorder->stop();
+      writer->finish();
+      if (writer->stalls > 0)
+      {
+        LOG_WARN(LOG_TB, "Trace-Puffer %llu-mal voll, die Simulation hat auf den Writer gewartet.",
+                 (unsigned long long)writer->stalls);
+      }
+      delete writer;
+      writer = nullptr;
+    }
+    state = DONE;
+  }
+
+private:
+  enum State
+  {
+    WAITING,
+    OPEN,
+    DONE
+  };
+
+  std::string filename;
+  bool async;
+  uint32_t start;
+  uint32_t end;
+  bool end_relative;
+  uint8_t trigger;
+  uint32_t trigger_index;
+  uint32_t trigger_lo;
+  uint32_t trigger_hi;
+  bool triggered;
+
+  std::set<std::string> selection;
+  std::set<std::string> used;
+  std::vector<TraceProbe> probes;
+  SIGNAL_RECORDER *recorder = nullptr;
+  AsyncVcdWriter *writer = nullptr;
+
+  State state = WAITING;
+  uint64_t end_at = 0;
+  sc_trace_file *tf = nullptr;
+
+  bool isSelected(const char *name, const char *group) const
+  {
+    return selection.count(name) > 0 ||
+           (group != nullptr && (selection.count(group) > 0 || selection.count("all") > 0));
+  }
+
+  void open(uint64_t now, uint64_t stop)
+  {
+    state = OPEN;
+    end_at = stop;
+    if (!async)
+    {
+      tf = sc_create_vcd_trace_file(filename.c_str());
+      for (const TraceProbe &probe : probes)
+      {
+        probe.trace(tf);
+      }
+      LOG_INFO(LOG_TB, "Tracing ab Takt %llu mit %zu Signalen: %s.vcd", (unsigned long long)now, probes.size(),
+               filename.c_str());
+      return;
+    }
+
+    if (recorder == nullptr)
+    {
+      state = DONE;
+      return;
+    }
+    std::vector<AsyncVcdWriter::Signal> signals;
+    for (const TraceProbe &probe : probes)
+    {
+      signals.push_back({probe.name, probe.width});
+    }
+    writer = new AsyncVcdWriter(filename, signals, sc_get_time_resolution().to_string());
+    if (!writer->ok())
+    {
+      LOG_ERROR(LOG_TB, "Kann Trace-Datei nicht anlegen: %s", filename.c_str());
+      delete writer;
+      writer = nullptr;
+      state = DONE;
+      return;
+    }
+    recorder->start(writer);
+    LOG_INFO(LOG_TB, "Tracing ab Takt %llu mit %zu Signalen (im Hintergrund): %s", (unsigned long long)now,
+             probes.size(), filename.c_str());
+  }
+};
+
+#endif // TRACE_WINDOW_HPP
@@ -0,0 +1,281 @@
+#ifndef VCD_WRITER_HPP
+#define VCD_WRITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+// Schreibt Wertänderungen als VCD in einem Hintergrund-Thread. Der Simulations-Thread legt die
+// Änderungen nur in einem Ringpuffer ab (ein Erzeuger, ein Verbraucher, ohne Sperren);
+// Formatieren, Komprimieren und Schreiben geschehen im Hintergrund. Endet der Dateiname auf
+// ".gz", wird gzip-komprimiert. Nach jeweils etwa COMPRESSED_SYNC_BYTES komprimierten Bytes wird
+// dabei vor einem Zeitstempel ein voller Flush eingefügt, ab dem sich der Datenstrom ohne den
+// vorherigen Inhalt entpacken lässt (raw inflate). Die Flush-Punkte stehen in "<Datei>.idx", je
+// Zeile: Offset in der komprimierten Datei, Offset im entpackten VCD, Zeitstempel.
+class AsyncVcdWriter
+{
+public:
+  struct Signal
+  {
+    std::string name;
+    unsigned width;
+  };
+
+  static constexpr size_t COMPRESSED_SYNC_BYTES = 4u << 20;
+
+  // capacity: Anzahl der Einträge im Ringpuffer, wird auf eine Zweierpotenz aufgerundet
+  AsyncVcdWriter(const std::string &filename, const std::vector<Signal> &signals, const std::string &timescale,
+                 size_t capacity = 1u << 20)
+      : signals(signals)
+  {
+    size_t size = 1;
+    while (size < capacity)
+    {
+      size <<= 1;
+    }
+    ring.resize(size);
+    mask = size - 1;
+
+    if (filename.size() >= 3 && filename.compare(filename.size() - 3, 3, ".gz") == 0)
+    {
+      gz = gzopen(filename.c_str(), "wb6");
+      if (gz != nullptr)
+      {
+        index = std::fopen((filename + ".idx").c_str(), "w");
+      }
+      if (index != nullptr)
+      {
+        std::fprintf(index, "# Flush-Punkte von %s: komprimierter Offset, entpackter Offset, Zeitstempel\n",
+                     filename.c_str());
+      }
+    }
+    else
+    {
+      file = std::fopen(filename.c_str(), "w");
+    }
+    if (!ok())
+    {
+      return;
+    }
+    writeHeader(timescale);
+    worker = std::thread(&AsyncVcdWriter::drain, this);
+  }
+
+  ~AsyncVcdWriter()
+  {
+    finish();
+  }
+
+  bool ok() const
+  {
+    return file != nullptr || gz != nullptr;
+  }
+
+  // Nur vom Simulations-Thread aufrufen. Ist der Puffer voll, wird gewartet, bis der
+  // Hintergrund-Thread Platz geschaffen hat (gezählt in stalls).
+  void push(uint64_t time, uint32_t id, uint32_t value)
+  {
+    size_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) > mask)
+    {
+      stalls++;
+      while (h - tail.load(std::memory_order_acquire) > mask)
+      {
+        std::this_thread::yield();
+      }
+    }
+    ring[h & mask] = Event{time, id, value};
+    head.store(h + 1, std::memory_order_release);
+  }
+
+  // Schreibt alle ausstehenden Änderungen und schließt die Datei.
+  void finish()
+  {
+    if (!worker.joinable())
+    {
+      return;
+    }
+    done.store(true, std::memory_order_release);
+    worker.join();
+    flushBuffer();
+    if (gz != nullptr)
+    {
+      gzclose(gz);
+      gz = nullptr;
+    }
+    if (index != nullptr)
+    {
+      std::fclose(index);
+      index = nullptr;
+    }
+    if (file != nullptr)
+    {
+      std::fclose(file);
+      file = nullptr;
+    }
+  }
+
+  // Wie oft push() auf einen vollen Puffer gewartet hat
+  uint64_t stalls = 0;
+
+private:
+  struct Event
+  {
+    uint64_t time;
+    uint32_t id;
+    uint32_t value;
+  };
+
+  std::vector<Signal> signals;
+  std::vector<Event> ring;
+  size_t mask;
+  std::atomic<size_t> head{0};
+  std::atomic<size_t> tail{0};
+  std::atomic<bool> done{false};
+  std::thread worker;
+
+  // Nur vom Hintergrund-Thread verwendet (bzw. vor dessen Start und nach join)
+  FILE *file = nullptr;
+  gzFile gz = nullptr;
+  FILE *index = nullptr; // Flush-Punkte der gzip-Datei
+  std::string buffer;
+  uint64_t last_time = UINT64_MAX;
+  z_off_t sync_offset = 0; // komprimierter Offset des letzten Flush-Punkts
+  bool sync_due = false;   // vor dem nächsten Zeitstempel einen Flush-Punkt setzen
+
+  static std::string identifier(uint32_t id)
+  {
+    // Druckbare Zeichen '!' bis '~' als Ziffern zur Basis 94
+    std::string code;
+    do
+    {
+      code += static_cast<char>('!' + id % 94);
+      id /= 94;
+    } while (id > 0);
+    return code;
+  }
+
+  void writeHeader(const std::string &timescale)
+  {
+    buffer += "$version\n  graS25MemoryCU AsyncVcdWriter\n$end\n";
+    buffer += "$timescale\n  " + timescale + "\n$end\n";
+    buffer += "$scope module SystemC $end\n";
+    for (size_t i = 0; i < signals.size(); i++)
+    {
+      buffer += "$var wire " + std::to_string(signals[i].width) + " " + identifier(i) + " " + signals[i].name + " $end\n";
+    }
+    buffer += "$upscope $end\n$enddefinitions $end\n";
+  }
+
+  void format(const Event &e)
+  {
+    if (e.time != last_time)
+    {
+      if (sync_due)
+      {
+        sync(e.time);
+      }
+      char stamp[24];
+      int n = std::snprintf(stamp, sizeof(stamp), "#%llu\n", static_cast<unsigned long long>(e.time));
+      buffer.append(stamp, n);
+      last_time = e.time;
+    }
+
+    unsigned width = signals[e.id].width;
+    if (width == 1)
+    {
+      buffer += e.value ? '1' : '0';
+    }
+    else
+    {
+      // Binärdarstellung ohne führende Nullen
+      buffer += 'b';
+      int bit = 31;
+      while (bit > 0 && !((e.value >> bit) & 1))
+      {
+        bit--;
+      }
+      for (; bit >= 0; bit--)
+      {
+        buffer += ((e.value >> bit) & 1) ? '1' : '0';
+      }
+      buffer += ' ';
+    }
+    buffer += identifier(e.id);
+    buffer += '\n';
+  }
+
+  void flushBuffer()
+  {
+    if (buffer.empty())
+    {
+      return;
+    }
+    if (gz != nullptr)
+    {
+      gzwrite(gz, buffer.data(), static_cast<unsigned>(buffer.size()));
+      // gzoffset() kostet einen Systemaufruf und wird deshalb nur hier abgefragt. Er zählt nur,
+      // was zlib schon geschrieben hat; der Abstand der Flush-Punkte ist also ungefähr.
+      sync_due = gzoffset(gz) - sync_offset >= static_cast<z_off_t>(COMPRESSED_SYNC_BYTES);
+    }
+    else if (file != nullptr)
+    {
+      std::fwrite(buffer.data(), 1, buffer.size(), file);
+    }
+    buffer.clear();
+  }
+
+  // Voller Flush vor dem Zeitstempel time, Eintrag im Index
+  void sync(uint64_t time)
+  {
+    flushBuffer();
+    gzflush(gz, Z_FULL_FLUSH);
+    sync_offset = gzoffset(gz);
+    sync_due = false;
+    if (index != nullptr)
+    {
+      std::fprintf(index, "%lld %lld %llu\n", static_cast<long long>(sync_offset), static_cast<long long>(gztell(gz)),
+                   static_cast<unsigned long long>(time));
+    }
+  }
+
+  void drain()
+  {
+    size_t t = tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+      // done zuerst lesen: Ist es gesetzt, enthält head bereits alle Einträge.
+      bool finishing = done.load(std::memory_order_acquire);
+      size_t h = head.load(std::memory_order_acquire);
+      if (t == h)
+      {
+        if (finishing)
+        {
+          break;
+        }
+        flushBuffer();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        continue;
+      }
+      // In Stücken freigeben, damit der Erzeuger nicht auf einen ganzen Durchlauf wartet
+      size_t end = h - t > 4096 ? t + 4096 : h;
+      for (; t != end; t++)
+      {
+        format(ring[t & mask]);
+      }
+      tail.store(t, std::memory_order_release);
+      if (buffer.size() >= (64u << 10))
+      {
+        flushBuffer();
+      }
+    }
+  }
+};
+
+#endif // VCD_WRITER_HPP
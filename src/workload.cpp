@@ -0,0 +1,212 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "workload.hpp"
+
+#define WORKLOAD_DEFAULT_COUNT 1000
+#define WORKLOAD_DEFAULT_SIZE 0x100000
+#define WORKLOAD_DEFAULT_STRIDE 64
+#define WORKLOAD_DEFAULT_BLOCK 64
+
+static const struct
+{
+    const char *name;
+    const char *alias;
+    uint8_t pattern;
+} patterns[] = {
+    {"seq", "sequential", WORKLOAD_SEQUENTIAL},
+    {"stride", "strided", WORKLOAD_STRIDED},
+    {"random", "uniform", WORKLOAD_RANDOM},
+    {"zipf", "zipfian", WORKLOAD_ZIPF},
+    {"contention", "users", WORKLOAD_CONTENTION},
+};
+
+const char *workload_name(uint8_t pattern)
+{
+    for (const auto &p : patterns)
+    {
+        if (p.pattern == pattern)
+        {
+            return p.name;
+        }
+    }
+    return "?";
+}
+
+// Ganze Zahl (dezimal oder mit 0x) ohne Rest, gibt 0 bei Erfolg zurück.
+static int parse_u64(const std::string &text, uint64_t max, uint64_t *value)
+{
+    if (text.empty() || text[0] == '-')
+    {
+        return 1;
+    }
+    char *end = nullptr;
+    unsigned long long v = std::strtoull(text.c_str(), &end, 0);
+    if (*end != '\0' || v > max)
+    {
+        return 1;
+    }
+    *value = v;
+    return 0;
+}
+
+static int set_option(struct WorkloadSpec *spec, const std::string &key, const std::string &value)
+{
+    uint64_t v = 0;
+    if (key == "theta")
+    {
+        char *end = nullptr;
+        spec->theta = std::strtod(value.c_str(), &end);
+        return value.empty() || *end != '\0' || !(spec->theta > 0 && spec->theta < 1);
+    }
+    uint64_t max = key == "seed" ? UINT64_MAX : key == "write" || key == "shared" ? 100 : key == "wide" ? 1
+                   : key == "user" || key == "users" ? 255 : UINT32_MAX;
+    if (parse_u64(value, max, &v) != 0)
+    {
+        return 1;
+    }
+    if (key == "n")
+        spec->count = static_cast<uint32_t>(v);
+    else if (key == "base")
+        spec->base = static_cast<uint32_t>(v);
+    else if (key == "size")
+        spec->size = static_cast<uint32_t>(v);
+    else if (key == "stride")
+        spec->stride = static_cast<uint32_t>(v);
+    else if (key == "wide")
+        spec->wide = static_cast<uint8_t>(v);
+    else if (key == "write")
+        spec->write_percent = static_cast<uint8_t>(v);
+    else if (key == "user")
+        spec->user = static_cast<uint8_t>(v);
+    else if (key == "users")
+        spec->users = static_cast<uint8_t>(v);
+    else if (key == "shared")
+        spec->shared_percent = static_cast<uint8_t>(v);
+    else if (key == "block")
+        spec->block = static_cast<uint32_t>(v);
+    else if (key == "seed")
+        spec->seed = v;
+    else
+        return 1;
+    return 0;
+}
+
+int workload_parse(const char *text, uint32_t default_base, struct WorkloadSpec *spec)
+{
+    memset(spec, 0, sizeof(*spec));
+    spec->count = WORKLOAD_DEFAULT_COUNT;
+    spec->base = default_base;
+    spec->size = WORKLOAD_DEFAULT_SIZE;
+    spec->stride = WORKLOAD_DEFAULT_STRIDE;
+    spec->wide = 1;
+    spec->write_percent = 30;
+    spec->users = 4;
+    spec->shared_percent = 20;
+    spec->block = WORKLOAD_DEFAULT_BLOCK;
+    spec->theta = 0.99;
+    spec->seed = 1;
+
+    std::string s(text);
+    size_t colon = s.find(':');
+    std::string name = s.substr(0, colon);
+    bool known = false;
+    for (const auto &p : patterns)
+    {
+        if (name == p.name || name == p.alias)
+        {
+            spec->pattern = p.pattern;
+            known = true;
+        }
+    }
+    if (!known)
+    {
+        fprintf(stderr, "Unbekanntes Lastmuster: %s\n", name.c_str());
+        return 1;
+    }
+
+    size_t pos = colon == std::string::npos ? s.size() : colon + 1;
+    while (pos < s.size())
+    {
+        size_t comma = s.find(',', pos);
+        if (comma == std::string::npos)
+        {
+            comma = s.size();
+        }
+        std::string item = s.substr(pos, comma - pos);
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || set_option(spec, item.substr(0, eq), item.substr(eq + 1)) != 0)
+        {
+            fprintf(stderr, "Ungültige Angabe im Lastmuster: %s\n", item.c_str());
+            return 1;
+        }
+        pos = comma + 1;
+    }
+
+    uint32_t align = spec->wide ? 4 : 1;
+    if (spec->size < align || static_cast<uint64_t>(spec->base) + spec->size > UINT64_C(0x100000000))
+    {
+        fprintf(stderr, "Der Adressbereich des Lastmusters muss mindestens %u Bytes lang sein und in 32 Bit passen.\n", align);
+        return 1;
+    }
+    if ((spec->pattern == WORKLOAD_ZIPF || spec->pattern == WORKLOAD_CONTENTION) &&
+        (spec->block < align || spec->block > spec->size))
+    {
+        fprintf(stderr, "Die Blockgröße des Lastmusters muss zwischen %u und der Bereichsgröße liegen.\n", align);
+        return 1;
+    }
+    if (spec->pattern == WORKLOAD_CONTENTION && spec->users == 0)
+    {
+        fprintf(stderr, "Das Lastmuster contention braucht mindestens einen Benutzer.\n");
+        return 1;
+    }
+    return 0;
+}
+
+int workload_generate(const struct WorkloadSpec *spec, struct Request **requests)
+{
+    // Wie bei den übrigen Quellen ein Eintrag mehr, damit auch 0 Anfragen ein gültiges Feld ergeben
+    struct Request *out = static_cast<struct Request *>(malloc((static_cast<size_t>(spec->count) + 1) * sizeof(struct Request)));
+    if (out == nullptr)
+    {
+        fprintf(stderr, "Fehler: Kein Speicher für %u Anfragen.\n", spec->count);
+        return 1;
+    }
+    WorkloadGenerator generator(*spec);
+    for (uint32_t i = 0; i < spec->count; i++)
+    {
+        out[i] = generator.next();
+    }
+    *requests = out;
+    return 0;
+}
+
+struct WorkloadStream
+{
+    WorkloadGenerator generator;
+    uint32_t remaining;
+};
+
+struct WorkloadStream *workload_stream_create(const struct WorkloadSpec *spec)
+{
+    return new WorkloadStream{WorkloadGenerator(*spec), spec->count};
+}
+
+uint32_t workload_stream_read(void *stream, struct Request *buf, uint32_t max)
+{
+    WorkloadStream *s = static_cast<WorkloadStream *>(stream);
+    uint32_t count = max < s->remaining ? max : s->remaining;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        buf[i] = s->generator.next();
+    }
+    s->remaining -= count;
+    return count;
+}
+
+void workload_stream_destroy(struct WorkloadStream *stream)
+{
+    delete stream;
+}
@@ -0,0 +1,67 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdint.h>
+#include "rahmenprogramm.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // Muster der synthetischen Lasten (siehe workload.hpp)
+    enum WorkloadPattern
+    {
+        WORKLOAD_SEQUENTIAL = 0, // fortlaufende Adressen
+        WORKLOAD_STRIDED = 1,    // Adressen im Abstand stride
+        WORKLOAD_RANDOM = 2,     // gleichverteilt im Adressbereich
+        WORKLOAD_ZIPF = 3,       // Blöcke nach Zipf-Verteilung, wenige heiße Blöcke
+        WORKLOAD_CONTENTION = 4  // mehrere Benutzer, teils auf einem gemeinsamen Block
+    };
+
+    // Beschreibung einer synthetischen Last. Textform für --workload:
+    // "<seq|stride|random|zipf|contention>[:Schlüssel=Wert,...]" mit den Schlüsseln n, base, size,
+    // stride, wide, write, user, users, shared, block, theta und seed, z.B.
+    // "zipf:n=1000000,theta=0.9,block=64".
+    struct WorkloadSpec
+    {
+        uint8_t pattern;         // enum WorkloadPattern
+        uint32_t count;          // Anzahl der Anfragen
+        uint32_t base;           // Beginn des Adressbereichs
+        uint32_t size;           // Länge des Adressbereichs in Bytes
+        uint32_t stride;         // Abstand bei WORKLOAD_STRIDED
+        uint8_t wide;            // 1 = 4-Byte-Zugriffe (ausgerichtet), 0 = 1 Byte
+        uint8_t write_percent;   // Anteil der Schreibzugriffe
+        uint8_t user;            // Benutzer aller Anfragen außer bei WORKLOAD_CONTENTION
+        uint8_t users;           // WORKLOAD_CONTENTION: Benutzer 1..users, reihum
+        uint8_t shared_percent;  // WORKLOAD_CONTENTION: Anteil der Zugriffe auf den gemeinsamen Block
+        uint32_t block;          // Blockgröße in Bytes für WORKLOAD_ZIPF und WORKLOAD_CONTENTION
+        double theta;            // Schiefe der Zipf-Verteilung, 0 < theta < 1
+        uint64_t seed;
+    };
+
+    // Liest die Textform; nicht angegebene Werte erhalten Standardwerte, base ist default_base.
+    // Gibt 0 bei Erfolg zurück.
+    int workload_parse(const char *text, uint32_t default_base, struct WorkloadSpec *spec);
+
+    // Erzeugt spec->count Anfragen in einem mit malloc angelegten Feld. Gibt 0 bei Erfolg zurück.
+    int workload_generate(const struct WorkloadSpec *spec, struct Request **requests);
+
+    const char *workload_name(uint8_t pattern);
+
+    // Erzeugt die spec->count Anfragen einer Last stückweise, ohne sie alle im Speicher zu halten
+    struct WorkloadStream;
+
+    struct WorkloadStream *workload_stream_create(const struct WorkloadSpec *spec);
+
+    // Schreibt bis zu max weitere Anfragen nach buf und gibt ihre Anzahl zurück, 0 = Ende.
+    // Passt als request_source_fn (siehe sim_session.h), context ist der Strom.
+    uint32_t workload_stream_read(void *stream, struct Request *buf, uint32_t max);
+
+    void workload_stream_destroy(struct WorkloadStream *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORKLOAD_H
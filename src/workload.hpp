@@ -0,0 +1,134 @@
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include <cmath>
+#include <cstdint>
+
+#include "workload.h"
+
+// Erzeugt die Anfragen einer WorkloadSpec einzeln und deterministisch (gleicher seed, gleiche
+// Folge), ohne sie vorher im Speicher abzulegen. So lassen sich auch sehr lange Lasten als Strom
+// erzeugen; workload_generate() füllt damit ein Feld.
+//  - WORKLOAD_SEQUENTIAL: base, base+1 (bzw. +4 bei wide), ... mit Umlauf am Ende des Bereichs
+//  - WORKLOAD_STRIDED: wie sequentiell, aber im Abstand stride
+//  - WORKLOAD_RANDOM: gleichverteilt im Bereich
+//  - WORKLOAD_ZIPF: Der Bereich wird in Blöcke geteilt, Block k (ab base) wird mit
+//    Wahrscheinlichkeit proportional zu 1/(k+1)^theta gewählt (Verfahren von Gray et al.,
+//    "Quickly Generating Billion-Record Synthetic Databases"), die Adresse im Block gleichverteilt.
+//  - WORKLOAD_CONTENTION: Die Benutzer 1..users stellen reihum Anfragen. Mit shared_percent
+//    greifen sie auf den ersten Block des Bereichs zu, den sich alle teilen, sonst gleichverteilt
+//    auf ihren eigenen Teil des restlichen Bereichs.
+class WorkloadGenerator
+{
+public:
+    explicit WorkloadGenerator(const struct WorkloadSpec &spec) : spec(spec), state(spec.seed)
+    {
+        blocks = spec.block > 0 ? spec.size / spec.block : 0;
+        if (spec.pattern == WORKLOAD_ZIPF && blocks > 0)
+        {
+            double zetan = 0;
+            for (uint32_t i = 1; i <= blocks; i++)
+            {
+                zetan += 1.0 / std::pow(static_cast<double>(i), spec.theta);
+            }
+            zipf_zetan = zetan;
+            zipf_alpha = 1.0 / (1.0 - spec.theta);
+            zipf_half = std::pow(0.5, spec.theta);
+            zipf_eta = (1.0 - std::pow(2.0 / blocks, 1.0 - spec.theta)) / (1.0 - (1.0 + zipf_half) / zetan);
+        }
+    }
+
+    struct Request next()
+    {
+        struct Request req = {};
+        uint32_t offset = 0;
+        uint32_t align = spec.wide ? 4 : 1;
+        switch (spec.pattern)
+        {
+        case WORKLOAD_SEQUENTIAL:
+            offset = static_cast<uint32_t>((index * align) % spec.size);
+            break;
+        case WORKLOAD_STRIDED:
+            offset = static_cast<uint32_t>((index * spec.stride) % spec.size);
+            break;
+        case WORKLOAD_ZIPF:
+            offset = zipfBlock() * spec.block + uniform(spec.block);
+            break;
+        case WORKLOAD_CONTENTION:
+        {
+            uint32_t u = static_cast<uint32_t>(index % spec.users);
+            req.user = static_cast<uint8_t>(u + 1);
+            uint32_t part = (spec.size - spec.block) / spec.users;
+            if (uniform(100) < spec.shared_percent || part < align)
+            {
+                offset = uniform(spec.block);
+            }
+            else
+            {
+                offset = spec.block + u * part + uniform(part);
+            }
+            break;
+        }
+        default:
+            offset = uniform(spec.size);
+            break;
+        }
+        if (spec.pattern != WORKLOAD_CONTENTION)
+        {
+            req.user = spec.user;
+        }
+        req.addr = spec.base + offset - offset % align;
+        req.wide = spec.wide;
+        req.w = uniform(100) < spec.write_percent;
+        req.data = req.w ? static_cast<uint32_t>(random()) : 0;
+        // Eine Anfragedatei lässt für 1-Byte-Schreibzugriffe nur Daten bis 0xFF zu (parse_csv_file)
+        if (!spec.wide)
+        {
+            req.data &= 0xFF;
+        }
+        index++;
+        return req;
+    }
+
+private:
+    struct WorkloadSpec spec;
+    uint64_t state;
+    uint64_t index = 0;
+    uint32_t blocks;
+    double zipf_zetan = 0;
+    double zipf_alpha = 0;
+    double zipf_half = 0;
+    double zipf_eta = 0;
+
+    // splitmix64
+    uint64_t random()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t uniform(uint32_t range)
+    {
+        return range > 0 ? static_cast<uint32_t>(random() % range) : 0;
+    }
+
+    uint32_t zipfBlock()
+    {
+        double u = static_cast<double>(random() >> 11) * (1.0 / 9007199254740992.0);
+        double uz = u * zipf_zetan;
+        if (uz < 1.0)
+        {
+            return 0;
+        }
+        if (uz < 1.0 + zipf_half)
+        {
+            return blocks > 1 ? 1 : 0;
+        }
+        uint32_t k = static_cast<uint32_t>(blocks * std::pow(zipf_eta * u - zipf_eta + 1.0, zipf_alpha));
+        return k < blocks ? k : blocks - 1;
+    }
+};
+
+#endif // WORKLOAD_HPP
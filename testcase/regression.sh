@@ -0,0 +1,202 @@
+#!/bin/sh
+# Regressionsläufe gegen das gebaute Programm. Vergleicht Modelle und Varianten, die laut ihrer
+# Beschreibung dieselben Takte liefern müssen, über alle Testfälle in diesem Verzeichnis.
+#
+# Verwendung: testcase/regression.sh <Programm>
+# Rückgabe 0, wenn alle Vergleiche übereinstimmen.
+
+SIM=${1:?"Verwendung: $0 <Programm>"}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+failed=0
+
+# Alle Anfragedateien; csvParseTest.csv muss in beiden Läufen gleich scheitern.
+CASES="$DIR/*.csv"
+
+# Kleine ROM, damit die Testfälle auch den Hauptspeicher treffen, und die Standardgröße
+ROM_SIZES="16 0x100000"
+
+# Mit WITH_STATS=1 werden auch die Latenzen je Anfrage (--stats) verglichen.
+WITH_STATS=0
+
+# Mit WITH_TRACE=1 wird auch die VCD-Datei (--tf) ohne Datum und Version verglichen.
+WITH_TRACE=0
+
+# Mit WITH_DATA=1 werden auch die gelesenen Daten je Anfrage und das Speicherabbild am Ende
+# (--ram file:) bis hinter die höchste Adresse der Anfragedatei verglichen.
+WITH_DATA=0
+
+# Mit ONLY_DATA=1 werden die Takte nicht verglichen, nur Fehler, gelesene Daten und Abbild.
+ONLY_DATA=0
+
+# Höchste Adresse der Anfragedatei plus 4, dezimal
+image_limit()
+{
+    awk -F, '
+        NR > 1 {
+            a = tolower($2)
+            gsub(/[" ]/, "", a)
+            v = 0
+            if (a ~ /^0x/) {
+                for (i = 3; i <= length(a); i++) {
+                    v = v * 16 + index("0123456789abcdef", substr(a, i, 1)) - 1
+                }
+            } else {
+                v = a + 0
+            }
+            if (v > max) {
+                max = v
+            }
+        }
+        END { printf "%.0f\n", max + 4 }' "$1"
+}
+
+# Takte und Fehler aus der Zusammenfassung, dazu der Rückgabewert
+summary()
+{
+    out=$1
+    shift
+    rm -f "$out.json" "$out.vcd" "$out.img"
+    if [ $WITH_DATA -eq 1 ]; then
+        set -- --log-level warn,tb=debug --ram "file:$out.img" "$@"
+    fi
+    if [ $WITH_STATS -eq 1 ]; then
+        set -- --stats "$out.json" "$@"
+    fi
+    if [ $WITH_TRACE -eq 1 ]; then
+        set -- --tf "$out.vcd" "$@"
+    fi
+    "$SIM" "$@" >"$out.log" 2>/dev/null
+    echo "rc=$?" >"$out"
+    if [ $ONLY_DATA -eq 1 ]; then
+        grep -E '^Fehler' "$out.log" >>"$out"
+    else
+        grep -E '^(Zyklen|Fehler)' "$out.log" >>"$out"
+    fi
+    if [ $WITH_DATA -eq 1 ]; then
+        grep -o 'Anfrage [0-9]* gelesen: .*' "$out.log" >>"$out"
+        if [ -f "$out.img" ]; then
+            echo "Abbild: $(head -c "$IMAGE_LIMIT" "$out.img" | cksum)" >>"$out"
+        fi
+    fi
+    if [ -f "$out.json" ]; then
+        cat "$out.json" >>"$out"
+    fi
+    if [ -f "$out.vcd" ]; then
+        sed -e '/^\$date/,/^\$end/d' -e '/^\$version/,/^\$end/d' "$out.vcd" >>"$out"
+    fi
+}
+
+# compare <Name> "<Optionen A>" "<Optionen B>" "<gemeinsame Optionen>"
+compare()
+{
+    name=$1
+    for csv in $CASES; do
+        IMAGE_LIMIT=$(image_limit "$csv")
+        for rom in $ROM_SIZES; do
+            # Die Optionen werden absichtlich an Leerzeichen getrennt
+            summary "$TMP/a" $2 $4 --rom-size "$rom" "$csv"
+            summary "$TMP/b" $3 $4 --rom-size "$rom" "$csv"
+            if ! cmp -s "$TMP/a" "$TMP/b"; then
+                echo "FEHLER $name: $(basename "$csv") --rom-size $rom $4"
+                diff "$TMP/a" "$TMP/b" | sed 's/^/    /'
+                failed=1
+            fi
+        done
+    done
+}
+
+# --mode lt bildet die Takte des signalgenauen Modells nach (main_memory_lt.hpp), auch mit
+# Byte-Enable, DRAM-Modell, fester Speicherlatenz und ROM-Prefetcher, und liefert dieselben
+# gelesenen Daten und denselben Speicherinhalt.
+# writeReexecTest.csv enthält die Fälle, in denen das Signalmodell einen Schreibzugriff
+# wiederholt und der Speicher für den nächsten Zugriff belegt ist.
+WITH_DATA=1
+for opts in "" "--byte-enable" "--dram" "--dram --byte-enable" "--latency-mem 3" "--rom-prefetch 2 --latency-rom 3"; do
+    compare "lt/signal" "--mode lt" "--mode signal" "$opts"
+done
+
+# Byte-Enable, Schreibpuffer und Write-Back-Cache ändern nur die Takte: Gelesene Daten und das
+# Abbild am Ende (Puffer geleert, geänderte Zeilen zurückgeschrieben) müssen gleich bleiben.
+ONLY_DATA=1
+for opts in "--byte-enable" "--store-buffer 4" "--store-buffer 4 --byte-enable" "--cache-size 256"; do
+    compare "daten" "" "$opts" ""
+done
+ONLY_DATA=0
+WITH_DATA=0
+
+# Mit nur einem Benutzer muss --split-users dieselben Takte, Fehler und Latenzen je Anfrage
+# liefern wie die Testbench, die die Anfragen nacheinander stellt (multi_master.hpp).
+SINGLE="$TMP/single"
+mkdir -p "$SINGLE"
+for csv in $CASES; do
+    awk -F, 'BEGIN { OFS = "," } NR > 1 && NF >= 5 { $4 = "1" } { print }' "$csv" >"$SINGLE/$(basename "$csv")"
+done
+CASES="$SINGLE/*.csv"
+WITH_STATS=1
+for opts in "" "--byte-enable" "--dram" "--store-buffer 4" "--processes method"; do
+    compare "split-users/einzeln" "--split-users" "" "$opts"
+done
+WITH_STATS=0
+CASES="$DIR/*.csv"
+
+# ROM, deren Größe kein Vielfaches von 4 ist: Das unvollständige letzte Wort muss in jedem
+# Format und Modell mit den Bytes aus der Datei gelesen werden (rom_image.hpp).
+ODD="$TMP/odd"
+mkdir -p "$ODD"
+printf '\001\002\003\004\005\006' >"$ODD/rom.bin"
+printf '0x04030201\n0x00000605\n' >"$ODD/rom.txt"
+printf ':06000000010203040506E5\n:00000001FF\n' >"$ODD/rom.hex"
+cat >"$ODD/reads.csv" <<EOF
+"Type","Address","Data","User","Wide"
+"R","0x0","","1","T"
+"R","0x4","","1","T"
+"R","0x4","","1","F"
+"R","0x5","","1","F"
+EOF
+cat >"$ODD/expected" <<EOF
+ROM hat 4B-Wert gefunden: 0x04030201 an Adresse 0x00000000.
+ROM hat 4B-Wert gefunden: 0x00000605 an Adresse 0x00000004.
+ROM hat 1B-Wert gefunden: 0x00000005 an Adresse 0x00000004.
+ROM hat 1B-Wert gefunden: 0x00000006 an Adresse 0x00000005.
+EOF
+for mode in signal lt; do
+    for rom in "$ODD/rom.bin" "$ODD/rom.txt" "$ODD/rom.hex"; do
+        "$SIM" --mode $mode --rom-size 6 --rom-content "$rom" --log-level warn,rom=debug "$ODD/reads.csv" 2>/dev/null |
+            grep -o 'ROM hat .*' >"$ODD/actual"
+        if ! cmp -s "$ODD/expected" "$ODD/actual"; then
+            echo "FEHLER rom-size 6: --mode $mode $(basename "$rom")"
+            diff "$ODD/expected" "$ODD/actual" | sed 's/^/    /'
+            failed=1
+        fi
+    done
+done
+
+# --processes method muss dieselben Takte, Fehler, Latenzen und Signalverläufe liefern wie die
+# SC_THREADs. Die Varianten decken die Abkürzungen über clk.posedge() in MC_IDLE und
+# MC_WORD_WRITE_IDLE (Byte-Enable), die Wartezeiten über mehrere Flanken mit EdgeTimer (Latenzen
+# ab 2 Takten, DRAM, ROM-Prefetcher) und die Master, deren r/w und read_en erst in einem späteren
+# Delta-Zyklus wechseln (--split-users, Schreibpuffer), ab.
+WITH_STATS=1
+WITH_TRACE=1
+for opts in "" "--byte-enable" "--dram" "--dram --byte-enable" "--latency-mem 1" "--latency-mem 3" \
+    "--latency-rom 1" "--latency-rom 5" "--rom-prefetch 2 --latency-rom 3" "--store-buffer 4" \
+    "--store-buffer 4 --byte-enable" "--cache-size 256" "--split-users" "--split-users --byte-enable"; do
+    compare "thread/method" "--processes thread" "--processes method" "$opts"
+done
+WITH_STATS=0
+WITH_TRACE=0
+
+# Mit BENCH=1 zusätzlich die Laufzeit beider Prozessarten messen (--bench, dauert länger).
+if [ "${BENCH:-0}" -eq 1 ]; then
+    for processes in thread method; do
+        echo "--processes $processes:"
+        "$SIM" --bench --processes $processes 2>/dev/null | sed 's/^/    /'
+    done
+fi
+
+if [ $failed -eq 0 ]; then
+    echo "Alle Vergleiche stimmen überein."
+fi
+exit $failed